@@ -13,6 +13,7 @@
 #include "SDKmisc.h"
 #include "TDXScene.h"
 #include "resource.h"
+#include <cstdint>                      // for std::uintptr_t
 #include <string>                       // for std::wstring, std::to_string
 #include <malloc.h>                     // for _aligned_malloc, _aligned_free
 #include <boost/format.hpp>             // for boost::wformat
@@ -52,6 +53,12 @@ static auto const WINDOWHEIGHT = 960;
 */
 static auto const WINDOWWIDTH = 1280;
 
+//! A global variable (constant).
+/*!
+    ブルーノイズ間引きで、生成した頂点数を何分の一にするか
+*/
+static auto const THINNINGRATIO = 4;
+
 //! A global variable.
 /*!
     CPUのスレッド数
@@ -130,6 +137,36 @@ auto redraw = true;
 */
 auto reim = TDXScene::Re_Im_type::REAL;
 
+//! A global variable.
+/*!
+    頂点をサンプリングする手法
+*/
+auto sampling = TDXScene::Sampling_type::REJECTION;
+
+//! A global variable.
+/*!
+    角度部分に表を使うかどうか
+*/
+auto angulartable = false;
+
+//! A global variable.
+/*!
+    角度部分の表のθ方向の区間の数
+*/
+auto angulartablesize = TDXScene::ANGULARTABLESIZE_FIRST;
+
+//! A global variable.
+/*!
+    角度部分の表の補間の方法
+*/
+auto interpolation = sampler::AngularTable::Interpolation_type::BILINEAR;
+
+//! A global variable.
+/*!
+    生成した頂点をブルーノイズ間引きするかどうか
+*/
+auto bluenoise = false;
+
 //--------------------------------------------------------------------------------------
 // UI control IDs
 //--------------------------------------------------------------------------------------
@@ -143,6 +180,11 @@ auto reim = TDXScene::Re_Im_type::REAL;
 #define IDC_RADIOB              8
 #define IDC_OUTPUT              9
 #define IDC_SLIDER				10
+#define IDC_SAMPLING            11
+#define IDC_ANGULAR             12
+#define IDC_TABLEOUTPUT         13
+#define IDC_TABLESIZE           14
+#define IDC_BLUENOISE           15
 
 //--------------------------------------------------------------------------------------
 // Forward declarations 
@@ -299,6 +341,11 @@ HRESULT CALLBACK OnD3D10CreateDevice(ID3D10Device* pd3dDevice, const DXGI_SURFAC
 
     auto buf = _aligned_malloc(sizeof(TDXScene), 16);
     scene.reset(new(buf)TDXScene(pgd));
+    scene->Sampling = sampling;
+    scene->Angulartable = angulartable;
+    scene->Angulartablesize = angulartablesize;
+    scene->Interpolation = interpolation;
+    scene->Thinningtarget = bluenoise ? scene->Vertexsize() / THINNINGRATIO : 0;
     return scene->Init(pd3dDevice);
 }
 
@@ -336,12 +383,24 @@ void RenderText(ID3D10Device* pd3dDevice, double fTime)
         end = true;
     }
 
-    std::wstring str;
+    // 最初の段階の点を描画できるまでの時間と、すべての点を詰め終わるまでの時間は分けて表示する
+    auto const preview = scene->Previewtime() > 0.0 ?
+        (boost::wformat(L"%.1fミリ秒") % (scene->Previewtime() * 1000.0)).str() : std::wstring(L"計算中");
+
+    std::wstring str, speed, effspeed;
     if (end) {
-        str = (boost::wformat(L"計算時間 = %.3f秒") % drawendtime).str();
+        str = (boost::wformat(L"計算時間: 最初のプレビュー = %s, 全頂点 = %.3f秒") % preview % drawendtime).str();
+        speed = (boost::wformat(L"生成速度 = %.0f頂点/秒") % (static_cast<double>(scene->Vertexsize()) / drawendtime)).str();
+        // 相関のある点は自己相関時間の分だけ、重み付きの点は有効サンプル率の分だけ割り引いて、独立な点に換算する
+        effspeed = (boost::wformat(L"実効生成速度 = %.0f頂点/秒") % (static_cast<double>(scene->Vertexsize()) / drawendtime / scene->Autocorrtime() * scene->Essratio())).str();
     }
     else {
-        str = (boost::wformat(L"計算時間 = %.3f秒") % (fTime - drawstarttime)).str();
+        str = (boost::wformat(L"計算時間: 最初のプレビュー = %s, 全頂点 = %.3f秒 (%d頂点を描画中)")
+            % preview
+            % (fTime - drawstarttime)
+            % scene->Drawsize()).str();
+        speed = L"生成速度 = 計算中";
+        effspeed = L"実効生成速度 = 計算中";
     }
     
     txthelper->Begin();
@@ -352,6 +411,37 @@ void RenderText(ID3D10Device* pd3dDevice, double fTime)
     txthelper->DrawTextLine((boost::wformat(L"CPUスレッド数: %d") % cputhread).str().c_str());
     txthelper->DrawTextLine((boost::wformat(L"頂点数 = %d") % scene->Vertexsize()).str().c_str());
     txthelper->DrawTextLine(str.c_str());
+    txthelper->DrawTextLine(speed.c_str());
+    txthelper->DrawTextLine(effspeed.c_str());
+    txthelper->DrawTextLine((boost::wformat(L"採択率 = %.2f%%") % (scene->Acceptance() * 100.0)).str().c_str());
+    txthelper->DrawTextLine((boost::wformat(L"前処理時間 = %.3f秒") % scene->Setuptime()).str().c_str());
+    txthelper->DrawTextLine((boost::wformat(L"再描画から最初の点まで = %.1fミリ秒, 描画の中止 = %.3fミリ秒") % (scene->Latency() * 1000.0) % (scene->Stoplatency() * 1000.0)).str().c_str());
+    txthelper->DrawTextLine((boost::wformat(L"再描画: 要求 = %d, 投入 = %d, 統合 = %d, 中止 = %d, 完了 = %d")
+        % scene->Redrawrequested()
+        % scene->Redrawsubmitted()
+        % scene->Redrawcoalesced()
+        % scene->Redrawcancelled()
+        % scene->Redrawcompleted()).str().c_str());
+    txthelper->DrawTextLine((boost::wformat(L"自己相関時間 = %.2f") % scene->Autocorrtime()).str().c_str());
+    txthelper->DrawTextLine((boost::wformat(L"有効サンプル率 = %.1f%%, <r> = %.3f") % (scene->Essratio() * 100.0) % scene->Meanr()).str().c_str());
+    if (sampling == TDXScene::Sampling_type::REJECTION) {
+        // 前段で棄却された試行の割合と、スプラインまで評価された試行の割合
+        txthelper->DrawTextLine((boost::wformat(L"前段で棄却: 動径 = %.1f%%, 角度 = %.1f%%, スプライン評価 = %.1f%%")
+            % (scene->Squeezeradial() * 100.0)
+            % (scene->Squeezeangular() * 100.0)
+            % ((1.0 - scene->Squeezeradial() - scene->Squeezeangular()) * 100.0)).str().c_str());
+    }
+    if (bluenoise && scene->Complete && scene->Drawsize() < scene->Vertexsize()) {
+        // 間引いた後の頂点数と、最近接距離のばらつき（小さいほど均一）
+        txthelper->DrawTextLine((boost::wformat(L"間引き後 = %d頂点 (%.3f秒), 最近接距離の変動係数 = %.3f → %.3f")
+            % scene->Drawsize()
+            % scene->Thinningtime()
+            % scene->Uniformitybefore()
+            % scene->Uniformity()).str().c_str());
+    }
+    if (scene->Angulartablebytes()) {
+        txthelper->DrawTextLine((boost::wformat(L"角度の表 = %.1fKB, 最大相対誤差 = %.2e") % (static_cast<double>(scene->Angulartablebytes()) / 1024.0) % scene->Angulartableerror()).str().c_str());
+    }
     txthelper->End();
     pd3dDevice->IASetInputLayout(scene->PInputLayout().get());
 }
@@ -496,10 +586,7 @@ void CALLBACK OnD3D10ReleasingSwapChain(void* pUserContext)
 //--------------------------------------------------------------------------------------
 void CALLBACK OnD3D10DestroyDevice(void* pUserContext)
 {
-    scene->Thread_end = true;
-    if (scene->Pth()->joinable()) {
-        scene->Pth()->detach();
-    }
+    StopDraw();
 
     g_DialogResourceManager.OnD3D10DestroyDevice();
     g_D3DSettingsDlg.OnD3D10DestroyDevice();
@@ -632,8 +719,57 @@ void CALLBACK OnGUIEvent(UINT nEvent, int nControlID, CDXUTControl* pControl, vo
         RedrawFlagTrue();
         break;
 
+    case IDC_SAMPLING:
+    {
+        auto const pItem = (static_cast<CDXUTComboBox *>(pControl))->GetSelectedItem();
+        if (pItem)
+        {
+            sampling = static_cast<TDXScene::Sampling_type>(reinterpret_cast<std::uintptr_t>(pItem->pData));
+            scene->Sampling = sampling;
+            RedrawFlagTrue();
+        }
+        break;
+    }
+
     case IDC_SLIDER:
         scene->Vertexsize(static_cast<std::vector<TDXScene::SimpleVertex2>::size_type>((reinterpret_cast<CDXUTSlider*>(pControl))->GetValue()));
+        scene->Thinningtarget = bluenoise ? scene->Vertexsize() / THINNINGRATIO : 0;
+
+        // 頂点数だけが変わったので、生成済みの点は使い回す
+        scene->Resize = true;
+        first = true;
+        break;
+
+    case IDC_ANGULAR:
+    {
+        auto const pItem = (static_cast<CDXUTComboBox *>(pControl))->GetSelectedItem();
+        if (pItem)
+        {
+            // 0なら表を使わず、それ以外は補間の方法+1
+            auto const data = reinterpret_cast<std::uintptr_t>(pItem->pData);
+            angulartable = data != 0;
+            if (angulartable) {
+                interpolation = static_cast<sampler::AngularTable::Interpolation_type>(data - 1);
+            }
+
+            scene->Angulartable = angulartable;
+            scene->Interpolation = interpolation;
+            RedrawFlagTrue();
+        }
+        break;
+    }
+
+    case IDC_TABLESIZE:
+        angulartablesize = (reinterpret_cast<CDXUTSlider*>(pControl))->GetValue();
+        scene->Angulartablesize = angulartablesize;
+        if (angulartable) {
+            RedrawFlagTrue();
+        }
+        break;
+
+    case IDC_BLUENOISE:
+        bluenoise = (reinterpret_cast<CDXUTCheckBox*>(pControl))->GetChecked();
+        scene->Thinningtarget = bluenoise ? scene->Vertexsize() / THINNINGRATIO : 0;
         RedrawFlagTrue();
         break;
 
@@ -679,8 +815,7 @@ void ReadData()
 
 void RedrawFlagTrue()
 {
-    StopDraw();
-    scene->Thread_end = false;
+    // 実行中の描画は次の再描画のときに打ち切られるので、ここでは終わるのを待たない
     scene->Redraw = true;
     first = true;
 }
@@ -758,6 +893,48 @@ void SetUI()
         }
     }
 
+    // サンプリング手法
+    CDXUTComboBox* pSamplingCombo;
+    g_HUD.AddComboBox(IDC_SAMPLING, 35, iY += 34, 125, 22, L'S', false, &pSamplingCombo);
+    if (pSamplingCombo)
+    {
+        pSamplingCombo->SetDropHeight(80);
+        pSamplingCombo->RemoveAllItems();
+        pSamplingCombo->AddItem(L"棄却法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::REJECTION)));
+        pSamplingCombo->AddItem(L"動径CDF法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::RADIALCDF)));
+        pSamplingCombo->AddItem(L"直接生成法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::EXACT)));
+        pSamplingCombo->AddItem(L"殻別包絡線法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::SHELL)));
+        pSamplingCombo->AddItem(L"ボクセル重点法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::VOXEL)));
+        pSamplingCombo->AddItem(L"MCMC法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::MCMC)));
+        pSamplingCombo->AddItem(L"準モンテカルロ法（Sobol列）", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::SOBOL)));
+        pSamplingCombo->AddItem(L"準モンテカルロ法（Halton列）", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::HALTON)));
+        pSamplingCombo->AddItem(L"SIMD一括棄却法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::BATCH)));
+        pSamplingCombo->AddItem(L"重み付きサンプル法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::WEIGHTED)));
+        pSamplingCombo->AddItem(L"層別サンプリング法", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(TDXScene::Sampling_type::STRATIFIED)));
+        pSamplingCombo->SetSelectedByData(reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(sampling)));
+    }
+
+    // 球面調和関数の求め方
+    CDXUTComboBox* pAngularCombo;
+    g_HUD.AddComboBox(IDC_ANGULAR, 35, iY += 34, 125, 22, L'T', false, &pAngularCombo);
+    if (pAngularCombo)
+    {
+        pAngularCombo->SetDropHeight(40);
+        pAngularCombo->RemoveAllItems();
+        pAngularCombo->AddItem(L"角度：直接計算", reinterpret_cast<LPVOID>(0));
+        pAngularCombo->AddItem(L"角度：表（双線形補間）", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(sampler::AngularTable::Interpolation_type::BILINEAR) + 1));
+        pAngularCombo->AddItem(L"角度：表（双三次補間）", reinterpret_cast<LPVOID>(static_cast<std::uintptr_t>(sampler::AngularTable::Interpolation_type::BICUBIC) + 1));
+        pAngularCombo->SetSelectedByData(reinterpret_cast<LPVOID>(angulartable ? static_cast<std::uintptr_t>(interpolation) + 1 : 0));
+    }
+
+    // 角度部分の表の大きさ
+    g_HUD.AddStatic(IDC_TABLEOUTPUT, L"角度の表の分割数", 20, iY += 34, 125, 22);
+    g_HUD.GetStatic(IDC_TABLEOUTPUT)->SetTextColor(D3DCOLOR_ARGB(255, 255, 255, 255));
+    g_HUD.AddSlider(IDC_TABLESIZE, 35, iY += 24, 125, 22, 16, 512, angulartablesize);
+
+    // 生成後のブルーノイズ間引き
+    g_HUD.AddCheckBox(IDC_BLUENOISE, L"ブルーノイズ間引き", 35, iY += 34, 125, 22, bluenoise);
+
     // 角度の調整
     g_HUD.AddStatic(IDC_OUTPUT, L"頂点数", 20, iY += 34, 125, 22);
     g_HUD.GetStatic(IDC_OUTPUT)->SetTextColor(D3DCOLOR_ARGB(255, 255, 255, 255));
@@ -767,8 +944,5 @@ void SetUI()
 
 void StopDraw()
 {
-    scene->Thread_end = true;
-    if (scene->Pth()->joinable()) {
-        scene->Pth()->join();
-    }
+    scene->StopFill();
 }
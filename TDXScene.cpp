@@ -6,40 +6,126 @@
 
 #include "DXUT.h"
 #include "DXUTmisc.h"
-#include "myrandom/myrand.h"
 #include "resource.h"
 #include "TDXScene.h"
+#include "sampler/balldomain.h"
+#include "sampler/envelope.h"
+#include <algorithm>                                            // for std::copy, std::max, std::min
+#include <cmath>                                                // for std::atan2, std::cbrt
 #include <mutex>                                                // for std::mutex
 #include <boost/assert.hpp>                                     // for BOOST_ASSERT
 #include <boost/cast.hpp>                                       // for boost::numeric_cast
-#include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic
+#include <boost/format.hpp>                                     // for boost::wformat
+#include <boost/math/common_factor_rt.hpp>                      // for boost::math::gcd
+#include <boost/math/constants/constants.hpp>                   // for boost::math::constants::pi
 #include <boost/range/algorithm.hpp>                            // for boost::fill
+#include <tbb/blocked_range.h>                                  // for tbb::blocked_range
 #include <tbb/parallel_for.h>                                   // for tbb::parallel_for
-#include <tbb/partitioner.h>                                    // for tbb::auto_partitioner
+#include <tbb/partitioner.h>                                    // for tbb::simple_partitioner
+#include <tbb/tick_count.h>                                     // for tbb::tick_count
 
 namespace tdxscene {
+	double const TDXScene::ENCLOSED_PROBABILITY = 0.999;
 	float const TDXScene::MAGNIFICATION = 1.2f;
 
 	TDXScene::TDXScene(std::shared_ptr<getdata::GetData> const & pgd) :
+		Acceptance([this]{
+			auto const trials = trials_.load();
+			return trials ? static_cast<double>(accepted_.load()) / static_cast<double>(trials) : 0.0; }, nullptr),
+		Angulartable(nullptr, [this](bool angulartable) {
+			angulartable_.store(angulartable);
+			return angulartable; }),
+		Angulartablebytes([this]{ return angulartablebytes_.load(); }, nullptr),
+		Angulartableerror([this]{ return angulartableerror_.load(); }, nullptr),
+		Angulartablesize(nullptr, [this](std::int32_t size) {
+			angulartablesize_.store(size);
+			return size; }),
+		Autocorrtime([this]{ return autocorrtime_.load(); }, nullptr),
 		Complete([this]{ return complete_.load(); }, nullptr),
-		Pth([this]{ return std::cref(pth_); }, nullptr),
+		Drawsize([this]{ return drawsize_.load(); }, nullptr),
+		Essratio([this]{ return essratio_.load(); }, nullptr),
+		Fill([this]{ return std::cref(fill_); }, nullptr),
+		Interpolation(nullptr, [this](sampler::AngularTable::Interpolation_type interpolation) {
+			interpolation_.store(interpolation);
+			return interpolation; }),
+		Latency([this]{ return latency_.load(); }, nullptr),
+		Meanr([this]{ return meanr_.load(); }, nullptr),
 		Pgd(nullptr, [this](std::shared_ptr<getdata::GetData> const & val) {
-			rmax_ = GetRmax(val);
+			rmax_ = GetRmax(val, ENCLOSED_PROBABILITY);
 			SetCamera();
 			return pgd_ = val;
 		}),
 		PInputLayout([this]{ return std::cref(pInputLayout_); }, nullptr),
-		Redraw(nullptr, [this](bool redraw){ return redraw_ = redraw; }),
+		Previewtime([this]{ return previewtime_.load(); }, nullptr),
+		Redraw(nullptr, [this](bool redraw) {
+			if (redraw) {
+				RequestRedraw(false);
+			}
+			else {
+				redraw_ = false;
+			}
+			return redraw; }),
+		Redrawcancelled([this]{ return redrawcancelled_.load(); }, nullptr),
+		Redrawcoalesced([this]{ return redrawcoalesced_.load() + pworker_->Coalesced(); }, nullptr),
+		Redrawcompleted([this]{ return redrawcompleted_.load(); }, nullptr),
+		Redrawrequested([this]{ return redrawrequested_.load(); }, nullptr),
+		Redrawsubmitted([this]{ return pworker_->Submitted(); }, nullptr),
+		Resize(nullptr, [this](bool resize) {
+			if (resize) {
+				RequestRedraw(true);
+			}
+			return resize; }),
+		Sampling(nullptr, [this](TDXScene::Sampling_type sampling) {
+			sampling_.store(sampling);
+			return sampling; }),
+		Setuptime([this]{ return setuptime_.load(); }, nullptr),
+		Squeezeangular([this]{
+			auto const trials = trials_.load();
+			return trials ? static_cast<double>(squeezeangular_.load()) / static_cast<double>(trials) : 0.0; }, nullptr),
+		Squeezeradial([this]{
+			auto const trials = trials_.load();
+			return trials ? static_cast<double>(squeezeradial_.load()) / static_cast<double>(trials) : 0.0; }, nullptr),
+		Stoplatency([this]{ return stoplatency_.load(); }, nullptr),
 		Thread_end(nullptr, [this](bool thread_end){ 
 			thread_end_.store(thread_end);
 			return thread_end; }),
+		Thinningtarget([this]{ return thinningtarget_.load(); }, [this](std::vector<SimpleVertex2>::size_type target) {
+			thinningtarget_.store(target);
+			return target; }),
+		Thinningtime([this]{ return thinningtime_.load(); }, nullptr),
+		Uniformity([this]{ return uniformity_.load(); }, nullptr),
+		Uniformitybefore([this]{ return uniformitybefore_.load(); }, nullptr),
 		Vertexsize([this]{ return vertexsize_.load(); }, [this](std::vector<SimpleVertex2>::size_type size) { 
 				vertexsize_.store(size);
 				return size; }),
+		accepted_(0),
+		angulartablebytes_(0),
+		angulartableerror_(0.0),
+		autocorrtime_(1.0),
+		dirtyfirst_(0),
+		envelopeover_(0),
+		essratio_(1.0),
+		generation_(0),
+		latency_(0.0),
+		meanr_(0.0),
 		projectionVariable_(nullptr),
+		pworker_(new utility::WorkerService()),
 		pgd_(pgd),
-		rmax_(GetRmax(pgd)),
+		previewtime_(0.0),
+		redrawcancelled_(0),
+		redrawcoalesced_(0),
+		redrawcompleted_(0),
+		redrawrequested_(0),
+		rmax_(GetRmax(pgd, ENCLOSED_PROBABILITY)),
+		setuptime_(0.0),
+		squeezeangular_(0),
+		squeezeradial_(0),
+		stoplatency_(0.0),
 		technique_(nullptr),
+		thinningtime_(0.0),
+		trials_(0),
+		uniformity_(0.0),
+		uniformitybefore_(0.0),
 		vertices_(VERTEXSIZE_FIRST),
 		viewVariable_(nullptr),
 		worldVariable_(nullptr)
@@ -47,6 +133,14 @@ namespace tdxscene {
 	}
 
 
+	TDXScene::~TDXScene()
+	{
+		// ジョブが参照するメンバ変数より先に、ワーカースレッドを止める
+		StopFill();
+		pworker_.reset();
+	}
+
+
 	HRESULT TDXScene::Init(ID3D10Device* pd3dDevice)
 	{
 		// Read the D3DX effect_ file
@@ -185,7 +279,7 @@ namespace tdxscene {
 		for (auto p = 0U; p < techDesc.Passes; ++p)
 		{
 			technique_->GetPassByIndex(p)->Apply(0);
-			pd3dDevice->Draw(vertexsize_, 0);
+			pd3dDevice->Draw(buffersize_, 0);
 		}
 
 		return S_OK;
@@ -209,154 +303,1043 @@ namespace tdxscene {
 	HRESULT TDXScene::RedrawFunc(std::int32_t m, ID3D10Device * pd3dDevice, TDXScene::Re_Im_type reim)
 	{
 		if (redraw_) {
-			if (vertices_.size() != vertexsize_) {
-				vertices_.resize(vertexsize_);
-			}
+			// 実行中のジョブは打ち切らせるだけで、終わるのを待たずに次のジョブを渡す
+			CancelFill();
+			auto const generation = generation_.load();
+			auto const reuse = reuse_;
+
+			// ジョブが使う設定はここで一度だけ読む（中止を受けたジョブが終わるまでの間に設定が変わっても、古いジョブは渡された設定のまま抜ける）
+			TDXScene::FillSettings const settings = {
+				m,
+				reim,
+				sampling_.load(),
+				angulartable_.load(),
+				angulartablesize_.load(),
+				interpolation_.load(),
+				thinningtarget_.load(),
+				vertexsize_.load()
+			};
+
+			auto const start = tbb::tick_count::now();
+			fill_ = pworker_->Submit([this, settings, generation, reuse, start] {
+				// このジョブが始まったのは、前のジョブが中止を受けて終わった後
+				stoplatency_.store((tbb::tick_count::now() - start).seconds());
+
+				// このジョブのタスクグループを、世代を確かめる前に中止できるようにしておく
+				// （確かめた後の中止要求は、このタスクグループを中止する）
+				tbb::task_group_context context;
+				PublishContext(&context);
+
+				// 始まる前に次の再描画が要求されていたら、何もせずに終わる
+				thread_end_.store(false);
+				if (generation != generation_.load()) {
+					PublishContext(nullptr);
+					redrawcoalesced_++;
+					return;
+				}
 
-			pth_.reset(new std::thread([this, m, reim]{ ClearFillSimpleVertex2(m, reim); }), [this](std::thread * pth)
-			{
-				if (pth->joinable()) {
-					thread_end_.store(true);
-					pth->join();
+				redrawstart_ = start;
+
+				// 頂点数だけが変わったなら、生成済みの点を残して差分だけを詰める
+				if (reuse && Reusable(settings)) {
+					ResizeSimpleVertex2(settings);
+				}
+				else {
+					ClearFillSimpleVertex2(settings);
 				}
 
-				utility::Safe_Delete<std::thread> sd;
-				sd(pth);
+				// タスクグループはこのジョブと共に消えるので、中止要求から指されないようにする
+				PublishContext(nullptr);
 			});
 			redraw_ = false;
+			reuse_ = false;
 		}
 
-		bd_.ByteWidth = sizeof(SimpleVertex2) * vertexsize_;
+		static auto const stride = static_cast<UINT>(sizeof(SimpleVertex2));
+		{
+			// ワーカースレッドがvertices_を作り直している間は転送しない
+			std::lock_guard<std::mutex> lock(verticesmutex_);
+
+			// 詰め終わったかどうかは、転送する前に読む（転送中に詰め終わったら、次のフレームでもう一度転送する）
+			auto const complete = complete_.load();
+			auto const size = drawsize_.load();
+			if (!size) {
+				buffersize_ = 0;
+				return S_OK;
+			}
+
+			// 頂点バッファが足りない時だけ作り直し、その時は中身をすべて転送する
+			auto first = dirtyfirst_.load();
+			auto const recreate = size > buffercapacity_;
+			if (recreate) {
+				bd_.ByteWidth = stride * static_cast<UINT>(size);
 
-		static D3D10_SUBRESOURCE_DATA InitData;
-		InitData.pSysMem = vertices_.data();
+				ID3D10Buffer * vertexBuffertmp;
+				if (!utility::v_return(pd3dDevice->CreateBuffer(&bd_, nullptr, &vertexBuffertmp))) {
+					return S_FALSE;
+				}
 
-		ID3D10Buffer * vertexBuffertmp;
-		if (!utility::v_return(pd3dDevice->CreateBuffer(&bd_, &InitData, &vertexBuffertmp))) {
-			return S_FALSE;
+				pVertexBuffer_.reset(vertexBuffertmp);
+				buffercapacity_ = size;
+				first = 0;
+			}
+
+			// 描画する頂点のうち、まだ転送していない範囲だけを転送する
+			if (first < size) {
+				D3D10_BOX box = { stride * static_cast<UINT>(first), 0, 0, stride * static_cast<UINT>(size), 1, 1 };
+				pd3dDevice->UpdateSubresource(pVertexBuffer_.get(), 0, &box, vertices_.data() + first, 0, 0);
+			}
+
+			// 段階ごとに描画する点は詰め終わった点だけなので一度だけ転送し、その場で詰めている点は詰め終わるまで毎フレーム転送する
+			if (complete || !inplace_) {
+				dirtyfirst_.store(size);
+			}
+
+			// 頂点数が減っただけなら転送はせず、描画する頂点数だけを減らす
+			buffersize_ = size;
 		}
 
 		// Set vertex buffer
-		static auto const stride = static_cast<UINT>(sizeof(SimpleVertex2));
 		static auto const offset = 0U;
-		pd3dDevice->IASetVertexBuffers(0, 1, &vertexBuffertmp, &stride, &offset);
-		pVertexBuffer_.reset(vertexBuffertmp);
+		auto const pvertexbuffer = pVertexBuffer_.get();
+		pd3dDevice->IASetVertexBuffers(0, 1, &pvertexbuffer, &stride, &offset);
 
 		return S_OK;
 	}
 
 
-	void TDXScene::ClearFillSimpleVertex2(std::int32_t m, TDXScene::Re_Im_type reim)
+	void TDXScene::StopFill()
+	{
+		auto const start = tbb::tick_count::now();
+
+		CancelFill();
+		if (fill_.valid()) {
+			fill_.wait();
+		}
+
+		stoplatency_.store((tbb::tick_count::now() - start).seconds());
+	}
+
+
+	void TDXScene::CancelFill()
+	{
+		// 実行待ちのジョブは古い要求として扱わせ、実行中のジョブはまだ始まっていないタスクごと打ち切らせる
+		++generation_;
+		thread_end_.store(true);
+
+		std::lock_guard<std::mutex> lock(contextmutex_);
+		if (pcontext_) {
+			pcontext_->cancel_group_execution();
+		}
+	}
+
+
+	void TDXScene::ClearFillSimpleVertex2(TDXScene::FillSettings const & settings)
 	{
 		complete_.store(false);
 
+		// 詰め終わるまでは、使い回せる点はない
+		filled_ = 0;
+
+		{
+			// 描画スレッドが頂点バッファへ転送している間は、vertices_を作り直さない
+			std::lock_guard<std::mutex> lock(verticesmutex_);
+			if (vertices_.size() != settings.Vertexsize) {
+				vertices_.resize(settings.Vertexsize);
+			}
+
+			// 層別サンプリングと重み付きの点は頂点数から層を決めるので、途中の段階の点は分布を表さない
+			// それらは詰めている途中の点もそのまま描画し、それ以外は段階ごとに詰め終わった点だけを描画する
+			inplace_.store(settings.Sampling == TDXScene::Sampling_type::STRATIFIED || settings.Sampling == TDXScene::Sampling_type::WEIGHTED);
+			drawsize_.store(inplace_ ? vertices_.size() : 0);
+			dirtyfirst_.store(0);
+		}
+
 		SimpleVertex2 sv2;
 		sv2.Col = { 0.0f, 0.0f, 0.0f, 0.0f };
 		sv2.Pos = { 0.0f, 0.0f, 0.0f };
 		boost::fill(vertices_, sv2);
+		weights_.assign(vertices_.size(), 1.0);
+
+		// 乱数のシードは再描画ごとに一度だけ設定する
+		randstreams_.reseed();
+
+		accepted_.store(0);
+		trials_.store(0);
+		envelopeover_.store(0);
+		previewtime_.store(0.0);
+		squeezeangular_.store(0);
+		squeezeradial_.store(0);
+		thinningtime_.store(0.0);
+		uniformity_.store(0.0);
+		uniformitybefore_.store(0.0);
+
+		auto const setupstart = tbb::tick_count::now();
+		PrepareSampling(settings);
+		setuptime_.store((tbb::tick_count::now() - setupstart).seconds());
+		latency_.store((tbb::tick_count::now() - redrawstart_).seconds());
+		if (inplace_) {
+			previewtime_.store(latency_.load());
+		}
 
-		tbb::parallel_for(
-			0,
-			boost::numeric_cast<std::int32_t>(vertexsize_.load()),
-			1,
-			[this, m, reim](std::int32_t i) { FillSimpleVertex2(m, reim, vertices_[i]); });
+		// 動径分布の層を選ぶ歩幅は、頂点数と互いに素で黄金比に近いものにする（描画途中の点も層全体に散らばる）
+		auto const nvertex = boost::numeric_cast<std::int32_t>(vertices_.size());
+		stratumstride_ = std::max(1, static_cast<std::int32_t>(0.6180339887498949 * static_cast<double>(nvertex)));
+		while (nvertex > 1 && boost::math::gcd(stratumstride_, nvertex) != 1) {
+			stratumstride_++;
+		}
+
+		// 層別サンプリングは層ごとのタスクで詰める（層ごとにシードを決めるので、何度描画しても同じ点になる）
+		// 中止が要求されたら、まだ始まっていないタスクは実行されず、実行中のタスクも試行の合間に抜ける
+		if (pstrata_) {
+			tbb::parallel_for(std::size_t(0), pstrata_->size(), [this](std::size_t s) {
+				FillSimpleVertex2Stratified(s);
+			}, *pcontext_);
+		}
+		else if (inplace_) {
+			FillSimpleVertex2Range(settings.Sampling, 0, nvertex);
+		}
+		else {
+			FillSimpleVertex2Progressive(settings.Sampling, 0, nvertex);
+		}
 
+		// 中止されたときは、描画している点をそのまま残して（その場で詰めていれば残りは透明な点のまま）、統計量と間引きは省く
+		if (pcontext_->is_group_execution_cancelled() || thread_end_) {
+			redrawcancelled_++;
+			complete_.store(true);
+			return;
+		}
+
+		StoreStatistics();
+
+		// 重み付きの点は、統計量を求めた後で重みのない点に選び直して描画する
+		if (settings.Sampling == TDXScene::Sampling_type::WEIGHTED && !thread_end_ && essratio_.load() > 0.0) {
+			ResampleVertices();
+		}
+
+		// 多めに生成した点をブルーノイズな部分集合に間引く（重み付きの点は、間引くと重みが分布を表さなくなるので間引かない）
+		// 間引いている途中で中止されたら、間引く前の点を描画したまま中止として数える
+		if (settings.Thinningtarget && settings.Thinningtarget < vertices_.size() && !thread_end_ && settings.Sampling != TDXScene::Sampling_type::WEIGHTED) {
+			if (!ThinVertices(settings.Thinningtarget)) {
+				redrawcancelled_++;
+				complete_.store(true);
+				return;
+			}
+		}
+
+#if defined( DEBUG ) || defined( _DEBUG )
+		if (envelopeover_.load()) {
+			::OutputDebugString((boost::wformat(L"包絡線を超えた試行が%d回ありました\n") % envelopeover_.load()).str().c_str());
+		}
+#endif
+
+		// 間引いていなければ、次に頂点数だけが変わったときに点を使い回せる
+		if (drawsize_.load() == vertices_.size()) {
+			filled_ = vertices_.size();
+			fillkey_ = std::make_tuple(pgd_.get(), settings.M, settings.Reim, settings.Sampling, settings.Angulartable, settings.Angulartablesize, settings.Interpolation);
+		}
+
+		redrawcompleted_++;
 		complete_.store(true);
 	}
 
 
-	void TDXScene::FillSimpleVertex2(std::int32_t m, TDXScene::Re_Im_type reim, SimpleVertex2 & ver)
+	void TDXScene::FillSimpleVertex2(TDXScene::Sampling_type sampling, myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
 	{
 		if (thread_end_) {
 			return;
 		}
 
-		auto pp = 0.0, p = 0.0;
-		auto sign = 0;
+		switch (sampling) {
+		case TDXScene::Sampling_type::REJECTION:
+			FillSimpleVertex2Rejection(rs, ver, counter);
+			break;
+
+		case TDXScene::Sampling_type::RADIALCDF:
+			FillSimpleVertex2RadialCdf(rs, ver, counter);
+			break;
+
+		case TDXScene::Sampling_type::EXACT:
+			FillSimpleVertex2Exact(rs, ver, counter);
+			break;
+
+		case TDXScene::Sampling_type::SHELL:
+			FillSimpleVertex2Shell(rs, ver, counter);
+			break;
+
+		case TDXScene::Sampling_type::VOXEL:
+			FillSimpleVertex2Voxel(rs, ver, counter);
+			break;
+
+		case TDXScene::Sampling_type::MCMC:
+			FillSimpleVertex2Mcmc(rs, ver);
+			break;
+
+		case TDXScene::Sampling_type::SOBOL:
+		case TDXScene::Sampling_type::HALTON:
+			FillSimpleVertex2Qmc(ver, counter);
+			break;
+
+		default:
+			BOOST_ASSERT(!"何かがおかしい!");
+			break;
+		}
+	}
+
+
+	void TDXScene::FillSimpleVertex2Batch(myrandom::Xoshiro256 & rs, std::int32_t first, std::int32_t last)
+	{
+		double x[sampler::BatchRejection::BATCH], y[sampler::BatchRejection::BATCH], z[sampler::BatchRejection::BATCH];
+		std::int32_t sign[sampler::BatchRejection::BATCH];
+
+		auto trials = 0ULL, accepted = 0ULL;
+		for (auto i = first; i < last;) {
+			if (thread_end_) {
+				break;
+			}
+
+			trials += sampler::BatchRejection::BATCH;
+			auto const n = (*pbatchrejection_)(rs, x, y, z, sign);
+
+			// ブロックの末尾で余った点は捨てる（候補は互いに独立なので分布は変わらない）
+			for (auto j = 0U; j < n && i < last; j++, i++) {
+				SetSimpleVertex2(x[j], y[j], z[j], sign[j], vertices_[i]);
+				accepted++;
+			}
+		}
+
+		trials_ += trials;
+		accepted_ += accepted;
+	}
+
+
+	void TDXScene::FillSimpleVertex2Exact(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		// rも(θ, φ)も分布から直接生成するので、棄却は一度も起こらない
+		auto const r = pgd_->RadialInvCdf(rs.myrand(0.0, radialcdfmax_));
+
+		double costheta, phi;
+		(*pangularsampler_)(rs, costheta, phi);
+
+		counter.Trials++;
+		counter.Accepted++;
+
+		auto const sintheta = std::sqrt(1.0 - costheta * costheta);
+		auto const ux = sintheta * std::cos(phi);
+		auto const uy = sintheta * std::sin(phi);
+
+		// 波動関数の符号だけのためにスプラインと球面調和関数を評価する
+		auto const psi = rho_ ? 1.0 : (*pgd_)(r) * YlmCartesian(ux, uy, costheta);
+		auto const sign = (psi > 0.0) - (psi < 0.0);
+
+		SetSimpleVertex2(r * ux, r * uy, r * costheta, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Mcmc(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver)
+	{
 		double x, y, z;
 
-		myrandom::MyRand mr(-rmax_, rmax_);
-		myrandom::MyRand mr2(pgd_->Funcmin, pgd_->Funcmax);
+		// 波動関数が恒等的に0の場合は連鎖を作っていないので、球内の一様乱数をそのまま採用する
+		if (!pchains_) {
+			sampler::BallDomain const ball(rmax_);
+			ball(rs, x, y, z);
+			SetSimpleVertex2(x, y, z, 0, ver);
+			return;
+		}
+
+		auto const pp = pchains_->local()(rs, x, y, z);
+		auto const sign = rho_ ? 1 : (pp > 0.0) - (pp < 0.0);
+
+		SetSimpleVertex2(x, y, z, sign, ver);
+	}
+
+
+	bool TDXScene::FillSimpleVertex2Progressive(TDXScene::Sampling_type sampling, std::int32_t first, std::int32_t last)
+	{
+		// 独立に作った点なら、詰め終わった段階までの点はそれだけで目的の分布に従う
+		// マルコフ連鎖の点は互いに相関していて、少ない点だけでは連鎖がまだ巡っていない領域が抜け落ちるので、最後まで詰めてから描画する
+		auto const progressive = sampling != TDXScene::Sampling_type::MCMC;
+		auto published = first;
+		while (published < last) {
+			auto const next = !progressive ? last :
+				!published ? std::min(static_cast<std::int32_t>(PREVIEWSIZE), last) :
+				published < last / PREVIEWRATIO ? published * PREVIEWRATIO : last;
+
+			FillSimpleVertex2Range(sampling, published, next);
+			if (pcontext_->is_group_execution_cancelled() || thread_end_) {
+				return false;
+			}
+
+			{
+				// 描画する頂点数を増やして、増えた点だけを転送させる
+				std::lock_guard<std::mutex> lock(verticesmutex_);
+				drawsize_.store(next);
+				dirtyfirst_.store(std::min(dirtyfirst_.load(), static_cast<std::vector<SimpleVertex2>::size_type>(published)));
+			}
+
+			if (!published) {
+				previewtime_.store((tbb::tick_count::now() - redrawstart_).seconds());
+			}
+
+			published = next;
+		}
+
+		return true;
+	}
+
+
+	void TDXScene::FillSimpleVertex2Qmc(SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		auto pp = 0.0;
+		auto r = 0.0, costheta = 0.0, phi = 0.0, ylm = 0.0;
+		auto trials = 0ULL;
+
+		// 候補の(r, cosθ, φ)と採否の判定に、4次元の点の各座標を一つずつ使う
+		double u[myrandom::QmcSequence::DIMENSION];
 
 		do {
 			if (thread_end_) {
 				return;
 			}
 
-			x = mr.myrand();
-			y = mr.myrand();
-			z = mr.myrand();
+			trials++;
 
-			auto const r = std::sqrt(x * x + y * y + z * z);
-			if (r < pgd_->R_meshmin()) {
-				continue;
+			qmcstreams_.next(u);
+			r = pgd_->RadialInvCdf(u[0] * radialcdfmax_);
+			costheta = 2.0 * u[1] - 1.0;
+			phi = 2.0 * boost::math::constants::pi<double>() * u[2];
+
+			if (zero_) {
+				ylm = 0.0;
+				break;
 			}
 
-			switch (pgd_->Rho_wf_type_) {
-			case getdata::GetData::Rho_Wf_type::RHO:
-			{
-				auto const phi = std::acos(x / std::sqrt(x * x + y * y));
-                double v;
-                if (m >= 0) {
-                    v = boost::math::spherical_harmonic_r(pgd_->L, m, std::acos(z / r), phi);
-                }
-                else {
-                    v = boost::math::spherical_harmonic_i(pgd_->L, m, std::acos(z / r), phi);
-                }
-                
-                pp = ((*pgd_)(r) * v * v);
-				p = mr2.myrand();
+			ylm = YlmAngles(costheta, phi);
+			pp = AngularDensity(ylm);
+
+#if defined( DEBUG ) || defined( _DEBUG )
+			if (pp > angularmax_) {
+				envelopeover_++;
 			}
-			break;
+#endif
+		} while (pp < u[3] * angularmax_);
 
-			case getdata::GetData::Rho_Wf_type::WF:
-			{
-				auto const phi = std::acos(x / std::sqrt(x * x + y * y));
-				double ylm = 0.0;
-				switch (reim) {
-				case TDXScene::Re_Im_type::REAL:
-					ylm = boost::math::spherical_harmonic_r(pgd_->L, m, std::acos(z / r), phi);
-					break;
+		counter.Trials += trials;
+		counter.Accepted++;
 
-				case TDXScene::Re_Im_type::IMAGINARY:
-					ylm = boost::math::spherical_harmonic_i(pgd_->L, m, std::acos(z / r), phi);
-					break;
+		auto const psi = rho_ ? 1.0 : (*pgd_)(r) * ylm;
+		auto const sign = (psi > 0.0) - (psi < 0.0);
 
-				default:
-					BOOST_ASSERT(!"何かがおかしい!");
-					break;
+		// 直交座標への変換は、採択された点についてだけ行う
+		auto const rsintheta = r * std::sqrt(1.0 - costheta * costheta);
+		SetSimpleVertex2(rsintheta * std::cos(phi), rsintheta * std::sin(phi), r * costheta, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Range(TDXScene::Sampling_type sampling, std::int32_t first, std::int32_t last)
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<std::int32_t>(first, last, FILLGRAIN),
+			[this, sampling](tbb::blocked_range<std::int32_t> const & range) {
+				// ワーカースレッドの乱数エンジンはブロックごとに一度だけ取り出す
+				auto & rs = randstreams_.local();
+
+				// SIMD化された棄却法はブロック単位でまとめて詰める
+				if (pbatchrejection_) {
+					FillSimpleVertex2Batch(rs, range.begin(), range.end());
+					return;
 				}
 
-				pp = (*pgd_)(r) * ylm;
-				p = mr2.myrand();
+				// 重み付きの点は、頂点の添字から動径分布の層を決める
+				if (sampling == TDXScene::Sampling_type::WEIGHTED) {
+					FillSimpleVertex2Weighted(rs, range.begin(), range.end());
+					return;
+				}
+
+				// 試行の回数はブロックの中で数え、共有のカウンタにはブロックごとに一度だけ足す
+				TDXScene::FillCounter counter;
+				for (auto i = range.begin(); i != range.end(); ++i) {
+					FillSimpleVertex2(sampling, rs, vertices_[i], counter);
+				}
+
+				trials_ += counter.Trials;
+				accepted_ += counter.Accepted;
+				squeezeradial_ += counter.Squeezeradial;
+				squeezeangular_ += counter.Squeezeangular;
+			},
+			tbb::simple_partitioner(),
+			*pcontext_);
+	}
+
+
+	void TDXScene::FillSimpleVertex2RadialCdf(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		auto pp = 0.0;
+		auto r = 0.0, costheta = 0.0, phi = 0.0, ylm = 0.0;
+		auto trials = 0ULL;
+
+		do {
+			if (thread_end_) {
+				return;
 			}
-			break;
 
-			default:
-				BOOST_ASSERT(!"何かがおかしい!");
+			trials++;
+
+			// rは動径分布の累積分布関数の逆関数から直接求める
+			r = pgd_->RadialInvCdf(rs.myrand(0.0, radialcdfmax_));
+			costheta = rs.myrand(-1.0, 1.0);
+			phi = rs.myrand(0.0, 2.0 * boost::math::constants::pi<double>());
+
+			if (zero_) {
+				ylm = 0.0;
 				break;
 			}
 
-			switch (pgd_->Rho_wf_type_) {
-			case getdata::GetData::Rho_Wf_type::RHO:
-				sign = 1;
+			ylm = YlmAngles(costheta, phi);
+			pp = AngularDensity(ylm);
+
+#if defined( DEBUG ) || defined( _DEBUG )
+			if (pp > angularmax_) {
+				envelopeover_++;
+			}
+#endif
+		} while (pp < rs.myrand(0.0, angularmax_));
+
+		counter.Trials += trials;
+		counter.Accepted++;
+
+		// 波動関数の符号だけのためにスプラインを評価する（採択された点のみ）
+		auto const psi = rho_ ? 1.0 : (*pgd_)(r) * ylm;
+		auto const sign = (psi > 0.0) - (psi < 0.0);
+
+		// 直交座標への変換は、採択された点についてだけ行う
+		auto const rsintheta = r * std::sqrt(1.0 - costheta * costheta);
+		SetSimpleVertex2(rsintheta * std::cos(phi), rsintheta * std::sin(phi), r * costheta, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Rejection(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		// 角度部分の上限（安全係数は動径部分の上限の方に含まれている）
+		auto const angularbound = angularmax_ / sampler::ENVELOPE_MARGIN;
+
+		// 最初の候補がメッシュの内側に落ちても採択されないように、pは正の値から始める
+		auto pp = 0.0, p = 1.0;
+		double x, y, z;
+
+		// 候補は半径rmaxの球の内部に直接生成する
+		sampler::BallDomain const ball(rmax_);
+		auto trials = 0ULL, squeezeradial = 0ULL, squeezeangular = 0ULL;
+
+		do {
+			if (thread_end_) {
+				return;
+			}
+
+			trials++;
+
+			auto const r = ball(rs, x, y, z);
+			if (r < pgd_->R_meshmin()) {
+				continue;
+			}
+
+			p = rs.myrand(0.0, envelope_);
+
+			if (zero_) {
+				pp = 0.0;
 				break;
+			}
+
+			// 第1段: 動径部分の上限と角度部分の最大値の積にも届かなければ、何も評価せずに棄却する
+			auto const radialbound = (*pradialbound_)(r);
+			if (radialbound * angularbound < p) {
+				squeezeradial++;
+				pp = 0.0;
+				continue;
+			}
 
-			case getdata::GetData::Rho_Wf_type::WF:
-				sign = (pp > 0.0) - (pp < 0.0);
+			// 第2段: 球面調和関数だけを評価し、動径部分の上限との積が届かなければスプラインを評価せずに棄却する
+			// （角度部分の表を使う場合は、方向を(cosθ, φ)に直して表から補間する）
+			auto const ylm = useangulartable_ ? (*pangulartable_)(z / r, std::atan2(y, x)) : YlmCartesian(x / r, y / r, z / r);
+			auto const angular = AngularDensity(ylm);
+			if (radialbound * angular < p) {
+				squeezeangular++;
+				pp = 0.0;
+				continue;
+			}
+
+			// 第3段: 生き残った候補についてだけスプラインを評価する
+			pp = rho_ ? (*pgd_)(r) * angular : (*pgd_)(r) * ylm;
+
+#if defined( DEBUG ) || defined( _DEBUG )
+			if (std::fabs(pp) > envelope_) {
+				envelopeover_++;
+			}
+#endif
+		} while (std::fabs(pp) < p);
+
+		counter.Trials += trials;
+		counter.Squeezeradial += squeezeradial;
+		counter.Squeezeangular += squeezeangular;
+		counter.Accepted++;
+
+		auto const sign = rho_ ? 1 : (pp > 0.0) - (pp < 0.0);
+		SetSimpleVertex2(x, y, z, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Shell(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		auto pp = 0.0, pmax = 0.0;
+		auto r = 0.0, costheta = 0.0, phi = 0.0;
+		auto trials = 0ULL;
+
+		do {
+			if (thread_end_) {
+				return;
+			}
+
+			trials++;
+
+			// 波動関数が恒等的に0の場合は殻を作っていないので、球内の一様乱数をそのまま採用する
+			if (!pradialshells_) {
+				r = rmax_ * std::cbrt(rs.myrand());
+				costheta = rs.myrand(-1.0, 1.0);
+				phi = rs.myrand(0.0, 2.0 * boost::math::constants::pi<double>());
+				pp = 0.0;
+				break;
+			}
+
+			// 包絡線の質量に比例して殻を選び、その殻の中で一様に点を取る
+			auto const i = (*pradialshells_)(rs);
+			pmax = pradialshells_->Max(i);
+			r = pradialshells_->SampleR(rs, i);
+			costheta = rs.myrand(-1.0, 1.0);
+			phi = rs.myrand(0.0, 2.0 * boost::math::constants::pi<double>());
+
+			auto const ylm = YlmAngles(costheta, phi);
+			pp = rho_ ? (*pgd_)(r) * ylm * ylm : (*pgd_)(r) * ylm;
+
+#if defined( DEBUG ) || defined( _DEBUG )
+			if (std::fabs(pp) > pmax) {
+				envelopeover_++;
+			}
+#endif
+		} while (std::fabs(pp) < rs.myrand(0.0, pmax));
+
+		counter.Trials += trials;
+		counter.Accepted++;
+
+		auto const sign = rho_ ? 1 : (pp > 0.0) - (pp < 0.0);
+
+		// 直交座標への変換は、採択された点についてだけ行う
+		auto const rsintheta = r * std::sqrt(1.0 - costheta * costheta);
+		SetSimpleVertex2(rsintheta * std::cos(phi), rsintheta * std::sin(phi), r * costheta, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Stratified(std::size_t s)
+	{
+		myrandom::Xoshiro256 rs(s);
+		auto const amax = pstrata_->Max(s);
+		auto trials = 0ULL, accepted = 0ULL;
+
+		for (auto i = pstrata_->First(s); i < pstrata_->Last(s); i++) {
+			if (thread_end_) {
 				break;
+			}
+
+			// rは殻の中でさらに層別化して取るので、棄却するのは角度だけ
+			auto const r = pgd_->RadialInvCdf(pstrata_->Quantile(s, i, rs.myrand()) * radialcdfmax_);
 
-			default:
-				BOOST_ASSERT(!"何かがおかしい!");
+			auto ylm = 0.0, a = 0.0;
+			double costheta, phi;
+			do {
+				trials++;
+
+				pstrata_->SampleAngles(rs, s, costheta, phi);
+				if (zero_) {
+					break;
+				}
+
+				ylm = YlmAngles(costheta, phi);
+				a = AngularDensity(ylm);
+
+#if defined( DEBUG ) || defined( _DEBUG )
+				if (a > amax) {
+					envelopeover_++;
+				}
+#endif
+			} while (a < rs.myrand(0.0, amax));
+
+			auto const psi = rho_ ? 1.0 : (*pgd_)(r) * ylm;
+			auto const sign = (psi > 0.0) - (psi < 0.0);
+
+			auto const rsintheta = r * std::sqrt(1.0 - costheta * costheta);
+			SetSimpleVertex2(rsintheta * std::cos(phi), rsintheta * std::sin(phi), r * costheta, sign, vertices_[i]);
+			accepted++;
+		}
+
+		trials_ += trials;
+		accepted_ += accepted;
+	}
+
+
+	void TDXScene::FillSimpleVertex2Voxel(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter)
+	{
+		auto pp = 0.0, pmax = 0.0;
+		double x, y, z;
+		auto trials = 0ULL;
+
+		do {
+			if (thread_end_) {
+				return;
+			}
+
+			trials++;
+
+			// 波動関数が恒等的に0の場合は格子を作っていないので、球内の一様乱数をそのまま採用する
+			if (!pvoxelgrid_) {
+				sampler::BallDomain const ball(rmax_);
+				ball(rs, x, y, z);
+				pp = 0.0;
 				break;
 			}
 
-			if (!m && pgd_->Rho_wf_type_ == getdata::GetData::Rho_Wf_type::WF && reim == TDXScene::Re_Im_type::IMAGINARY) {
+			// 上限に比例してボクセルを選び、その中で一様に点を取る（他のモードと同じく、半径rmaxの球の外側の点は棄却する）
+			auto const i = (*pvoxelgrid_)(rs);
+			pmax = pvoxelgrid_->Max(i);
+			pvoxelgrid_->SamplePoint(rs, i, x, y, z);
+			pp = x * x + y * y + z * z <= rmax_ * rmax_ ? Target(x, y, z) : 0.0;
+
+#if defined( DEBUG ) || defined( _DEBUG )
+			if (std::fabs(pp) > pmax) {
+				envelopeover_++;
+			}
+#endif
+		} while (std::fabs(pp) < rs.myrand(0.0, pmax));
+
+		counter.Trials += trials;
+		counter.Accepted++;
+
+		auto const sign = rho_ ? 1 : (pp > 0.0) - (pp < 0.0);
+
+		SetSimpleVertex2(x, y, z, sign, ver);
+	}
+
+
+	void TDXScene::FillSimpleVertex2Weighted(myrandom::Xoshiro256 & rs, std::int32_t first, std::int32_t last)
+	{
+		// 重みは角度部分の最大値で割って[0, 1]に収める（動径部分は提案分布と打ち消し合う）
+		auto const weightmax = angularmax_ / sampler::ENVELOPE_MARGIN;
+		auto const n = static_cast<double>(vertices_.size());
+
+		auto i = first;
+		for (; i < last; i++) {
+			if (thread_end_) {
 				break;
 			}
-			
-		} while (std::fabs(pp) < std::fabs(p));
 
+			// 頂点ごとに異なる層[s / n, (s + 1) / n)から動径分布の累積分布関数の値を取る
+			auto const stratum = static_cast<std::int64_t>(i) * stratumstride_ % static_cast<std::int64_t>(vertices_.size());
+			auto const r = pgd_->RadialInvCdf((static_cast<double>(stratum) + rs.myrand()) / n * radialcdfmax_);
+			auto const costheta = rs.myrand(-1.0, 1.0);
+			auto const phi = rs.myrand(0.0, 2.0 * boost::math::constants::pi<double>());
+
+			auto const ylm = zero_ ? 0.0 : YlmAngles(costheta, phi);
+			auto const w = zero_ ? 1.0 : AngularDensity(ylm) / weightmax;
+
+			auto const psi = rho_ ? 1.0 : (*pgd_)(r) * ylm;
+			auto const sign = (psi > 0.0) - (psi < 0.0);
+
+			auto const rsintheta = r * std::sqrt(1.0 - costheta * costheta);
+			SetSimpleVertex2(rsintheta * std::cos(phi), rsintheta * std::sin(phi), r * costheta, sign, vertices_[i]);
+
+			// 重みの小さい点ほど暗く描く
+			auto const brightness = static_cast<float>(std::min(w, 1.0));
+			vertices_[i].Col.r *= brightness;
+			vertices_[i].Col.g *= brightness;
+			vertices_[i].Col.b *= brightness;
+			weights_[i] = w;
+		}
+
+		// 棄却しないので、試行の回数と採択された点の数は等しい
+		trials_ += static_cast<std::uint64_t>(i - first);
+		accepted_ += static_cast<std::uint64_t>(i - first);
+	}
+
+
+	void TDXScene::PrepareSampling(TDXScene::FillSettings const & settings)
+	{
+		auto const m = settings.M;
+
+		// 描画範囲rmaxまでの動径分布だけを使う
+		radialcdfmax_ = pgd_->RadialCdf(rmax_);
+
+		// 電子密度か波動関数か、波動関数が恒等的に0かは再描画ごとに一度だけ求め、頂点ごとには求め直さない
+		// （虚部でm = 0の場合は波動関数が恒等的に0なので、各手法は最初の候補をそのまま採用する）
+		rho_ = pgd_->Rho_wf_type_ == getdata::GetData::Rho_Wf_type::RHO;
+		zero_ = !m && !rho_ && settings.Reim == TDXScene::Re_Im_type::IMAGINARY;
+
+		// 角度部分のサンプラーは再描画ごとに作り直す
+		auto const sine = rho_ ? m < 0 : settings.Reim == TDXScene::Re_Im_type::IMAGINARY;
+		pangularsampler_.reset(new sampler::AngularSampler(pgd_->L, m, sine, rho_));
+
+		// 目的の分布の上限を、(l, m, reim)ごとに動径部分と角度部分の最大値の積から求める
+		auto const ylmmax = sampler::YlmAbsMax(pgd_->L, m, sine);
+		angularmax_ = (rho_ ? ylmmax * ylmmax : ylmmax) * sampler::ENVELOPE_MARGIN;
+		envelope_ = pgd_->AbsMax(pgd_->R_meshmin, rmax_) * angularmax_;
+
+		// 球面調和関数は再描画ごとに一度だけ選び、試行ごとには分岐しない
+		// l ≦ 4なら(l, m, reim)に特殊化された多項式、それ以外はLegendre陪関数の漸化式で必要なmの列だけを計算する
+		pcartesianylm_.reset();
+		pylmladder_.reset();
+		if (pgd_->L <= sampler::CartesianYlm::LMAX) {
+			pcartesianylm_.reset(new sampler::CartesianYlm(pgd_->L, m, sine));
+			ylm_ = std::cref(*pcartesianylm_);
+		}
+		else {
+			pylmladder_.reset(new sampler::YlmLadder(pgd_->L));
+			auto const pylmladder = pylmladder_.get();
+			ylm_ = [pylmladder, m, sine](double ux, double uy, double uz) { return pylmladder->Value(m, sine, ux, uy, uz); };
+		}
+
+		// 角度部分の表は、(l, m, sine, 区間の数, 補間の方法)が変わった時だけ作り直す
+		// SIMD化された棄却法は候補の多項式をレーンごとにまとめて評価するので、表を引くとかえって遅くなるため表を使わない
+		// EXACTは角度を分布から直接生成し、VOXELとMCMCは目的の分布を直交座標のまま評価するので、これらも表を使わない
+		useangulartable_ = settings.Angulartable &&
+			settings.Sampling != TDXScene::Sampling_type::BATCH &&
+			settings.Sampling != TDXScene::Sampling_type::EXACT &&
+			settings.Sampling != TDXScene::Sampling_type::VOXEL &&
+			settings.Sampling != TDXScene::Sampling_type::MCMC;
+		if (useangulartable_) {
+			auto const key = std::make_tuple(pgd_->L(), m, sine, settings.Angulartablesize, settings.Interpolation);
+			if (!pangulartable_ || key != angulartablekey_) {
+				pangulartable_.reset(new sampler::AngularTable(
+					[this](double costheta, double phi) {
+						auto const sintheta = std::sqrt(1.0 - costheta * costheta);
+						return YlmCartesian(sintheta * std::cos(phi), sintheta * std::sin(phi), costheta);
+					},
+					std::get<3>(key),
+					std::get<4>(key)));
+				angulartablekey_ = key;
+			}
+
+			angulartablebytes_.store(pangulartable_->Bytes());
+			angulartableerror_.store(pangulartable_->AbsMax() > 0.0 ? pangulartable_->MaxError() / pangulartable_->AbsMax() : 0.0);
+		}
+		else {
+			angulartablebytes_.store(0);
+			angulartableerror_.store(0.0);
+		}
+
+		// 層別サンプリングの層は、角度部分の関数と頂点数が決まってから作る
+		pstrata_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::STRATIFIED) {
+			pstrata_.reset(new sampler::Strata(
+				[this](double costheta, double phi) {
+					// 波動関数が恒等的に0の場合は、立体角について一様に割り当てる
+					if (zero_) {
+						return 1.0;
+					}
+
+					return AngularDensity(YlmAngles(costheta, phi));
+				},
+				NSTRATUMSHELL,
+				NSTRATUMTHETA,
+				NSTRATUMPHI,
+				vertices_.size()));
+		}
+
+		// 動径方向の殻ごとの包絡線は、殻を使う時だけ作る
+		pradialshells_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::SHELL && ylmmax > 0.0) {
+			pradialshells_.reset(new sampler::RadialShells(*pgd_, rmax_, angularmax_, NSHELL));
+		}
+
+		// 球内の棄却法の前段で使う、区間ごとの動径部分の上限
+		pradialbound_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::REJECTION) {
+			pradialbound_.reset(new sampler::RadialBound(*pgd_, rmax_, NSHELL));
+		}
+
+		// SIMD化された棄却法のカーネルは、半径rmaxの球と同じ包絡線を使う
+		pbatchrejection_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::BATCH) {
+			pbatchrejection_.reset(new sampler::BatchRejection(*pgd_, m, sine, rmax_, envelope_));
+		}
+
+		// 低食い違い量列は再描画ごとに新しいスクランブルで先頭から使う
+		if (settings.Sampling == TDXScene::Sampling_type::SOBOL) {
+			qmcstreams_.reset(myrandom::QmcSequence::Sequence_type::SOBOL);
+		}
+		else if (settings.Sampling == TDXScene::Sampling_type::HALTON) {
+			qmcstreams_.reset(myrandom::QmcSequence::Sequence_type::HALTON);
+		}
+
+		// マルコフ連鎖はワーカースレッドごとに、最初に使われた時に作る
+		pchains_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::MCMC && ylmmax > 0.0) {
+			pchains_.reset(new tbb::enumerable_thread_specific<sampler::MetropolisChain>([this] {
+				return sampler::MetropolisChain(
+					[this](double x, double y, double z) { return Target(x, y, z); },
+					rmax_,
+					MCMC_BURNIN,
+					MCMC_THIN);
+			}));
+		}
+
+		// ボクセル格子は構築に時間がかかるので、使う時だけ作る
+		pvoxelgrid_.reset();
+		if (settings.Sampling == TDXScene::Sampling_type::VOXEL && ylmmax > 0.0) {
+			auto const l = static_cast<double>(pgd_->L());
+			pvoxelgrid_.reset(new sampler::VoxelGrid(
+				[this, ylmmax, l](double x, double y, double z, double radius) {
+					// 動径部分は、球が覆うrの範囲を挟むメッシュ点での最大値
+					auto const d = std::sqrt(x * x + y * y + z * z);
+					auto const radial = pgd_->AbsMax(std::max(d - radius, 0.0), d + radius);
+
+					// 角度部分は、中心の方向での値に、球が見込む角度の分だけの変化の上限を足す
+					// （次数lの球面調和関数は大円に沿ってlより高い周波数を持たないので、Bernsteinの不等式から傾きはl * max|Y|以下）
+					auto angular = ylmmax;
+					if (d > radius) {
+						auto const ylm = std::fabs(YlmCartesian(x / d, y / d, z / d));
+						angular = std::min(ylmmax, ylm + l * ylmmax * std::asin(radius / d));
+					}
+
+					return (rho_ ? radial * angular * angular : radial * angular) * sampler::ENVELOPE_MARGIN;
+				},
+				rmax_,
+				NVOXEL));
+		}
+	}
+
+
+	void TDXScene::PublishContext(tbb::task_group_context * pcontext)
+	{
+		std::lock_guard<std::mutex> lock(contextmutex_);
+		pcontext_ = pcontext;
+	}
+
+
+	void TDXScene::RequestRedraw(bool reuse)
+	{
+		// 次のフレームでジョブを渡す前に重なった要求は、一つの再描画にまとめられる
+		// まとめた要求のうち一つでも点を使い回せないものがあれば、すべて詰め直す
+		redrawrequested_++;
+		if (redraw_) {
+			redrawcoalesced_++;
+			reuse_ = reuse_ && reuse;
+		}
+		else {
+			reuse_ = reuse;
+		}
+
+		redraw_ = true;
+	}
+
+
+	void TDXScene::ResampleVertices()
+	{
+		std::vector<std::size_t> indices(vertices_.size());
+		sampler::Resample(randstreams_.local(), weights_, indices);
+
+		// 重みの小さい点を暗くしていたので、選び直した点は元の明るさに戻す
+		std::vector<SimpleVertex2> resampled(indices.size());
+		for (auto k = 0U; k < indices.size(); k++) {
+			auto & ver = resampled[k];
+			ver = vertices_[indices[k]];
+
+			auto const brightness = static_cast<float>(std::min(weights_[indices[k]], 1.0));
+			if (brightness > 0.0f) {
+				ver.Col.r /= brightness;
+				ver.Col.g /= brightness;
+				ver.Col.b /= brightness;
+			}
+		}
+
+		{
+			// 描画中の点を置き換えるので、転送し終えるのを待ってから詰め直して、先頭から転送させる
+			std::lock_guard<std::mutex> lock(verticesmutex_);
+			std::copy(resampled.begin(), resampled.end(), vertices_.begin());
+			dirtyfirst_.store(0);
+		}
+
+		// 選び直した点の重みはすべて等しい
+		weights_.assign(vertices_.size(), 1.0);
+	}
+
+
+	void TDXScene::ResizeSimpleVertex2(TDXScene::FillSettings const & settings)
+	{
+		complete_.store(false);
+
+		// 相関のあるMCMCの点は使い回さない（Reusable()を参照）。それ以外の点は一点ずつ目的の分布から生成したので、先頭から何個残しても目的の分布に従う
+		auto const first = filled_;
+		filled_ = 0;
+
+		SimpleVertex2 sv2;
+		sv2.Col = { 0.0f, 0.0f, 0.0f, 0.0f };
+		sv2.Pos = { 0.0f, 0.0f, 0.0f };
+
+		{
+			// 描画スレッドが頂点バッファへ転送している間は、vertices_を作り直さない
+			std::lock_guard<std::mutex> lock(verticesmutex_);
+			vertices_.resize(settings.Vertexsize, sv2);
+
+			// 残した点はそのまま描画し、増えた点は段階ごとに詰め終わったものから描画する
+			inplace_.store(false);
+			drawsize_.store(std::min(first, vertices_.size()));
+		}
+
+		weights_.resize(vertices_.size(), 1.0);
+		setuptime_.store(0.0);
+		latency_.store((tbb::tick_count::now() - redrawstart_).seconds());
+		previewtime_.store(latency_.load());
+
+		// 増えた分だけを詰める（乱数の状態は引き継ぐ。シードを設定し直すと、残した点と同じ点が生成されてしまう）
+		auto const last = vertices_.size();
+		if (first < last && !FillSimpleVertex2Progressive(settings.Sampling, boost::numeric_cast<std::int32_t>(first), boost::numeric_cast<std::int32_t>(last))) {
+			redrawcancelled_++;
+			complete_.store(true);
+			return;
+		}
+
+		StoreStatistics();
+
+		filled_ = last;
+		redrawcompleted_++;
+		complete_.store(true);
+	}
+
+
+	bool TDXScene::Reusable(TDXScene::FillSettings const & settings) const
+	{
+		// 層別サンプリングと重み付きの点は頂点数から層を決め、間引いた点は頂点数を変えると間引き方が変わるので、使い回せない
+		// MCMCの点はマルコフ連鎖の列で互いに相関しているので、先頭の一部だけでは目的の分布に従わず、やはり使い回せない
+		if (settings.Sampling == TDXScene::Sampling_type::STRATIFIED || settings.Sampling == TDXScene::Sampling_type::WEIGHTED ||
+			settings.Sampling == TDXScene::Sampling_type::MCMC || settings.Thinningtarget) {
+			return false;
+		}
+
+		return filled_ && filled_ == vertices_.size() &&
+			fillkey_ == std::make_tuple(pgd_.get(), settings.M, settings.Reim, settings.Sampling, settings.Angulartable, settings.Angulartablesize, settings.Interpolation);
+	}
+
+
+	void TDXScene::SetCamera()
+	{
+		// Initialize the view matrix
+		auto const pos = static_cast<float>(rmax_)* TDXScene::MAGNIFICATION;
+		D3DXVECTOR3 Eye(0.0f, pos, -pos);
+		D3DXVECTOR3 At(0.0f, 0.0f, 0.0f);
+		camera_.SetViewParams(&Eye, &At);
+	}
+
+
+	void TDXScene::SetSimpleVertex2(double x, double y, double z, std::int32_t sign, SimpleVertex2 & ver)
+	{
 		ver.Pos.x = static_cast<float>(x);
 		ver.Pos.y = static_cast<float>(y);
 		ver.Pos.z = static_cast<float>(z);
@@ -368,19 +1351,139 @@ namespace tdxscene {
 	}
 
 
-	void TDXScene::SetCamera()
+	void TDXScene::StoreStatistics()
 	{
-		// Initialize the view matrix
-		auto const pos = static_cast<float>(rmax_)* TDXScene::MAGNIFICATION;
-		D3DXVECTOR3 Eye(0.0f, pos, -pos);
-		D3DXVECTOR3 At(0.0f, 0.0f, 0.0f);
-		camera_.SetViewParams(&Eye, &At);
+		// マルコフ連鎖の統計をまとめる（採択率はバーンイン後の提案に対するもの）
+		if (pchains_) {
+			auto accepted = 0ULL, trials = 0ULL;
+			auto tau = 0.0;
+			auto nchain = 0;
+			for (auto const & chain : *pchains_) {
+				accepted += chain.Accepted();
+				trials += chain.Trials();
+				tau += chain.AutocorrTime();
+				nchain++;
+
+#if defined( DEBUG ) || defined( _DEBUG )
+				::OutputDebugString((boost::wformat(L"連鎖%d: 採択率 = %.2f%%, ステップ幅 = %.3f, 自己相関時間 = %.2f\n")
+					% nchain
+					% (chain.Trials() ? 100.0 * static_cast<double>(chain.Accepted()) / static_cast<double>(chain.Trials()) : 0.0)
+					% chain.Step()
+					% chain.AutocorrTime()).str().c_str());
+#endif
+			}
+
+			accepted_.store(accepted);
+			trials_.store(trials);
+			autocorrtime_.store(nchain ? tau / static_cast<double>(nchain) : 1.0);
+		}
+		else {
+			autocorrtime_.store(1.0);
+		}
+
+		// 重み付きの統計量（重みのないモードでは普通の平均になり、有効サンプル率は1になる）
+		auto const moments = sampler::GetWeightedMoments(vertices_, weights_);
+		essratio_.store(vertices_.empty() ? 1.0 : moments.Ess / static_cast<double>(vertices_.size()));
+		meanr_.store(moments.MeanR);
+	}
+
+
+	bool TDXScene::ThinVertices(std::vector<SimpleVertex2>::size_type target)
+	{
+		auto const start = tbb::tick_count::now();
+		auto const cancelled = [this] { return thread_end_.load(); };
+
+		// 最小距離の基準になる点の密度には、目的の分布そのものを使う
+		sampler::BlueNoiseThinning thinning(
+			vertices_,
+			[this](double x, double y, double z) { return std::fabs(Target(x, y, z)); },
+			rmax_);
+		auto const indices = thinning(target, cancelled);
+
+		// 中止されたら、間引く前の点を描画したまま抜ける
+		if (indices.empty() || thread_end_) {
+			return false;
+		}
+
+		// 選ばれた点を頂点バッファの先頭に詰めて、描画する頂点数を減らす
+		std::vector<SimpleVertex2> thinned(indices.size());
+		for (auto k = 0U; k < indices.size(); k++) {
+			thinned[k] = vertices_[indices[k]];
+		}
+		{
+			// 描画中の点を並べ替えるので、転送し終えるのを待ってから詰め直して、先頭から転送させる
+			std::lock_guard<std::mutex> lock(verticesmutex_);
+			std::copy(thinned.begin(), thinned.end(), vertices_.begin());
+			drawsize_.store(thinned.size());
+			dirtyfirst_.store(0);
+		}
+
+		thinningtime_.store((tbb::tick_count::now() - start).seconds());
+
+		// 比較の基準として、間引く前の点の先頭から同じ数だけ取った部分集合の均一さも求める
+		std::vector<std::size_t> head(indices.size());
+		for (auto k = 0U; k < head.size(); k++) {
+			head[k] = k;
+		}
+
+		// 均一さは間引いた点を描画した後で求めるので、中止されたら値を更新しないだけでよい
+		auto const uniformitybefore = thinning.Uniformity(head, cancelled);
+		auto const uniformity = thinning.Uniformity(indices, cancelled);
+		if (thread_end_) {
+			return false;
+		}
+
+		uniformitybefore_.store(uniformitybefore);
+		uniformity_.store(uniformity);
+
+#if defined( DEBUG ) || defined( _DEBUG )
+		::OutputDebugString((boost::wformat(L"間引き: 二分法の反復 = %d回\n") % thinning.Iterations()).str().c_str());
+#endif
+
+		return true;
+	}
+
+
+	double TDXScene::Target(double x, double y, double z) const
+	{
+		// データのメッシュの外側は0で打ち切る
+		// 描画範囲rmaxは動径分布の累積分布関数から求めるのでメッシュの内側にあり、外側に出るのはマルコフ連鎖の提案だけ（それは棄却される）
+		auto const r = std::sqrt(x * x + y * y + z * z);
+		if (r < pgd_->R_meshmin() || r > pgd_->R_meshmax()) {
+			return 0.0;
+		}
+
+		auto const ylm = YlmCartesian(x / r, y / r, z / r);
+		switch (pgd_->Rho_wf_type_) {
+		case getdata::GetData::Rho_Wf_type::RHO:
+			return (*pgd_)(r) * ylm * ylm;
+
+		case getdata::GetData::Rho_Wf_type::WF:
+			return (*pgd_)(r) * ylm;
+
+		default:
+			BOOST_ASSERT(!"何かがおかしい!");
+			return 0.0;
+		}
+	}
+
+
+	double TDXScene::YlmAngles(double costheta, double phi) const
+	{
+		// 表を使う場合は、三角関数も多項式も評価せずに格子点の値から補間する
+		if (useangulartable_) {
+			return (*pangulartable_)(costheta, phi);
+		}
+
+		auto const sintheta = std::sqrt(1.0 - costheta * costheta);
+		return YlmCartesian(sintheta * std::cos(phi), sintheta * std::sin(phi), costheta);
 	}
 
 
-	double GetRmax(std::shared_ptr<getdata::GetData> const & pgd)
+	double GetRmax(std::shared_ptr<getdata::GetData> const & pgd, double probability)
 	{
-		auto const n = static_cast<double>(pgd->N);
-		return (2.3622 * n + 3.3340) * n + 1.3228;
+		// 読み込み時に作った動径分布の累積分布関数から求めるので、水素様でない軌道にも合う
+		// （波動関数の場合も、描画する点の分布r^2|f(r)|についての割合）
+		return pgd->RadialInvCdf(probability);
 	}
 }
\ No newline at end of file
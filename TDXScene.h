@@ -13,11 +13,33 @@
 #include "DXUT.h"
 #include "DXUTcamera.h"
 #include "getdata/getdata.h"
+#include "myrandom/myrandstreams.h"
+#include "myrandom/qmcstreams.h"
+#include "sampler/angularsampler.h"
+#include "sampler/angulartable.h"
+#include "sampler/batchrejection.h"
+#include "sampler/bluenoisethinning.h"
+#include "sampler/cartesianylm.h"
+#include "sampler/metropolischain.h"
+#include "sampler/radialbound.h"
+#include "sampler/radialshells.h"
+#include "sampler/strata.h"
+#include "sampler/voxelgrid.h"
+#include "sampler/weightedsample.h"
+#include "sampler/ylmladder.h"
 #include "utility/property.h"
 #include "utility/utility.h"
+#include "utility/workerservice.h"
 #include <atomic>				// for std::atomic
+#include <cmath>                // for std::fabs
+#include <functional>           // for std::function
+#include <future>               // for std::future
 #include <memory>               // for std::shared_ptr, for std::unique_ptr
-#include <thread>               // for std::thread
+#include <mutex>                // for std::mutex
+#include <tuple>                // for std::tuple
+#include <tbb/enumerable_thread_specific.h>	// for tbb::enumerable_thread_specific
+#include <tbb/task.h>           // for tbb::task_group_context
+#include <tbb/tick_count.h>     // for tbb::tick_count
 #include <vector>               // for std::vector
 #include <d3dx9math.h>
 
@@ -66,164 +88,925 @@ namespace tdxscene {
 			IMAGINARY
 		};
 
+		//! A enumerated type
+		/*!
+			頂点をサンプリングする手法を表す列挙型
+		*/
+		enum class Sampling_type {
+			// 球内の一様乱数による棄却法
+			REJECTION,
+			// 動径分布の累積分布関数の逆関数でrを求め、角度部分のみ棄却法
+			RADIALCDF,
+			// rも(θ, φ)も分布から直接生成する（棄却なし）
+			EXACT,
+			// 動径方向の殻ごとの包絡線で棄却法
+			SHELL,
+			// ボクセル格子による重点サンプリング
+			VOXEL,
+			// ワーカースレッドごとのマルコフ連鎖によるメトロポリス・ヘイスティングス法
+			MCMC,
+			// スクランブルしたSobol列を候補に使う準モンテカルロ法
+			SOBOL,
+			// スクランブルしたHalton列を候補に使う準モンテカルロ法
+			HALTON,
+			// 候補をまとめてSIMDで評価する棄却法
+			BATCH,
+			// 層別化した動径分布と一様な角度の提案分布から棄却せずに生成し、重みを付ける
+			WEIGHTED,
+			// 質量の等しい動径方向の殻と角度方向のセルに、質量に比例した点の数を割り当てる層別サンプリング
+			STRATIFIED
+		};
+
 		// #endregion 列挙型
 
+		// #region 再描画のジョブが使う構造体
+
+		//! A struct.
+		/*!
+			ブロックを詰める間に数えた試行の回数（共有のカウンタには、ブロックを詰め終わった時に一度だけ足す）
+		*/
+		struct FillCounter {
+			//! A public member variable.
+			/*!
+				採択された点の数
+			*/
+			std::uint64_t Accepted = 0;
+
+			//! A public member variable.
+			/*!
+				角度部分の上限で棄却された試行の回数
+			*/
+			std::uint64_t Squeezeangular = 0;
+
+			//! A public member variable.
+			/*!
+				動径部分の上限で棄却された試行の回数
+			*/
+			std::uint64_t Squeezeradial = 0;
+
+			//! A public member variable.
+			/*!
+				試行の回数
+			*/
+			std::uint64_t Trials = 0;
+		};
+
+		//! A struct.
+		/*!
+			再描画のジョブが使う設定（ジョブを渡す時に一度だけ読み、実行中のジョブは設定の変更の影響を受けない）
+		*/
+		struct FillSettings {
+			//! A public member variable.
+			/*!
+				磁気量子数
+			*/
+			std::int32_t M;
+
+			//! A public member variable.
+			/*!
+				実部を描画するか、虚部を描画するか
+			*/
+			Re_Im_type Reim;
+
+			//! A public member variable.
+			/*!
+				サンプリング手法
+			*/
+			Sampling_type Sampling;
+
+			//! A public member variable.
+			/*!
+				角度部分に表を使うかどうか
+			*/
+			bool Angulartable;
+
+			//! A public member variable.
+			/*!
+				角度部分の表の、θ方向の区間の数
+			*/
+			std::int32_t Angulartablesize;
+
+			//! A public member variable.
+			/*!
+				角度部分の表の補間の方法
+			*/
+			sampler::AngularTable::Interpolation_type Interpolation;
+
+			//! A public member variable.
+			/*!
+				間引いた後の点の数（0なら間引かない）
+			*/
+			std::vector<SimpleVertex2>::size_type Thinningtarget;
+
+			//! A public member variable.
+			/*!
+				頂点数
+			*/
+			std::vector<SimpleVertex2>::size_type Vertexsize;
+		};
+
+		// #endregion 再描画のジョブが使う構造体
+
 		// #region コンストラクタ・デストラクタ
 
-		//! A constructor.
+		//! A constructor.
+		/*!
+			唯一のコンストラクタ
+		*/
+		explicit TDXScene(std::shared_ptr<getdata::GetData> const & pgd);
+
+		//! A destructor.
+		/*!
+		デストラクタ
+		*/
+		~TDXScene();
+
+		// #endregion コンストラクタ・デストラクタ
+
+		// #region メンバ関数
+
+		//! A public member function.
+		/*!
+			Direct3Dデバイスを初期化する
+			\param Direct3Dデバイスへのポインタ
+			\return 初期化が成功したかどうか
+		*/
+		HRESULT Init(ID3D10Device* pd3dDevice);
+
+		LRESULT MsgPrc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+
+		HRESULT OnFrameMove(double fTime, float fElapsedTime, void* pUserContext);
+		HRESULT OnRender(ID3D10Device* pd3dDevice, double fTime, float fElapsedTime, void* pUserContext);
+		HRESULT OnResize(ID3D10Device* pd3dDevice, IDXGISwapChain* pSwapChain,
+			const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc, void* pUserContext);
+
+		//! A public member function.
+		/*!
+			再描画する
+			\param m 磁気量子数
+			\param pd3dDevice DirectXデバイスへのスマートポインタ
+			\param reim 実部を描画するか、虚部を描画するか
+			\return 再描画が成功したかどうか
+		*/
+		HRESULT RedrawFunc(std::int32_t m, ID3D10Device * pd3dDevice, TDXScene::Re_Im_type reim);
+
+		//! A public member function.
+		/*!
+			実行中と実行待ちの描画を打ち切り、ワーカースレッドが描画をやめるまで待つ
+		*/
+		void StopFill();
+
+	private:
+		//! A private member function (const).
+		/*!
+			球面調和関数の値から、角度部分の分布の値を返す（電子密度なら2乗、波動関数なら絶対値）
+			\param ylm 球面調和関数の値
+			\return 角度部分の分布の値
+		*/
+		double AngularDensity(double ylm) const
+		{
+			return rho_ ? ylm * ylm : std::fabs(ylm);
+		}
+
+		//! A private member function.
+		/*!
+			実行中と実行待ちの描画に中止を要求する（終わるのは待たない）
+		*/
+		void CancelFill();
+
+		//! A private member function.
+		/*!
+			SimpleVertex2のデータをクリアし、新しいデータを詰める
+			\param settings ジョブを渡した時の設定
+		*/
+		void ClearFillSimpleVertex2(TDXScene::FillSettings const & settings);
+
+		//! A private member function.
+		/*!
+			SimpleVertex2にデータを詰める
+			\param sampling ジョブを渡した時のサンプリング手法
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2(TDXScene::Sampling_type sampling, myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			候補をまとめてSIMDで評価する棄却法で、vertices_の[first, last)にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param first 最初の頂点の添字
+			\param last 最後の頂点の次の添字
+		*/
+		void FillSimpleVertex2Batch(myrandom::Xoshiro256 & rs, std::int32_t first, std::int32_t last);
+
+		//! A private member function.
+		/*!
+			動径分布と角度分布から直接生成した点で、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2Exact(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			ワーカースレッドのマルコフ連鎖を進めて、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+		*/
+		void FillSimpleVertex2Mcmc(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver);
+
+		//! A private member function.
+		/*!
+			vertices_の[first, last)を、PREVIEWRATIO倍ずつ増える段階に分けて詰め、段階を詰め終わるごとに描画する頂点数を増やす
+			（MCMCの場合は段階に分けず、最後まで詰め終わってから描画する頂点数を増やす）
+			\param sampling ジョブを渡した時のサンプリング手法
+			\param first 最初の頂点の添字（これより前の頂点は描画中のまま残す）
+			\param last 最後の頂点の次の添字
+			\return 最後まで詰め終わったかどうか（中止されたときはfalse）
+		*/
+		bool FillSimpleVertex2Progressive(TDXScene::Sampling_type sampling, std::int32_t first, std::int32_t last);
+
+		//! A private member function.
+		/*!
+			動径分布の累積分布関数の逆関数と角度部分の棄却法に、低食い違い量列の候補を使ってSimpleVertex2にデータを詰める
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2Qmc(SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			vertices_の[first, last)に、与えられたサンプリングの手法で並列にデータを詰める（層別サンプリングを除く）
+			\param sampling ジョブを渡した時のサンプリング手法
+			\param first 最初の頂点の添字
+			\param last 最後の頂点の次の添字
+		*/
+		void FillSimpleVertex2Range(TDXScene::Sampling_type sampling, std::int32_t first, std::int32_t last);
+
+		//! A private member function.
+		/*!
+			動径分布の累積分布関数の逆関数を使って、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2RadialCdf(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			球内の一様乱数による棄却法で、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2Rejection(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			動径方向の殻ごとの包絡線を使った棄却法で、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2Shell(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			層別サンプリングで、一つの層に割り当てられた頂点にデータを詰める
+			乱数のシードは層の添字から決めるので、スレッドへの割り当てによらず同じ点が生成される
+			\param s 層の添字
+		*/
+		void FillSimpleVertex2Stratified(std::size_t s);
+
+		//! A private member function.
+		/*!
+			ボクセル格子による重点サンプリングで、SimpleVertex2にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param ver 対象のSimpleVertex2
+			\param counter 試行の回数を足すカウンタ
+		*/
+		void FillSimpleVertex2Voxel(myrandom::Xoshiro256 & rs, SimpleVertex2 & ver, TDXScene::FillCounter & counter);
+
+		//! A private member function.
+		/*!
+			棄却せずに重み付きの点を生成する方法で、vertices_とweights_の[first, last)にデータを詰める
+			\param rs 呼び出したスレッドの乱数エンジン
+			\param first 最初の頂点の添字
+			\param last 最後の頂点の次の添字
+		*/
+		void FillSimpleVertex2Weighted(myrandom::Xoshiro256 & rs, std::int32_t first, std::int32_t last);
+
+		//! A private member function.
+		/*!
+			再描画の前に、サンプリングに使う表や包絡線を作る
+			\param settings ジョブを渡した時の設定
+		*/
+		void PrepareSampling(TDXScene::FillSettings const & settings);
+
+		//! A private member function.
+		/*!
+			実行中のジョブのタスクグループを、中止要求から指されるようにする
+			\param pcontext ジョブのタスクグループ（ジョブが終わる時はnullptr）
+		*/
+		void PublishContext(tbb::task_group_context * pcontext);
+
+		//! A private member function.
+		/*!
+			再描画を要求する
+			\param reuse 生成済みの点を使い回してよいかどうか
+		*/
+		void RequestRedraw(bool reuse);
+
+		//! A private member function.
+		/*!
+			重み付きの点を、重みに比例して選び直した重みのない点に置き換え、頂点バッファの先頭から転送させる
+		*/
+		void ResampleVertices();
+
+		//! A private member function.
+		/*!
+			生成済みの点を残したまま頂点数を変え、増えた分だけを詰める
+			\param settings ジョブを渡した時の設定
+		*/
+		void ResizeSimpleVertex2(TDXScene::FillSettings const & settings);
+
+		//! A private member function (const).
+		/*!
+			生成済みの点を、頂点数を変えるだけで使い回せるかどうかを返す
+			\param settings ジョブを渡した時の設定
+			\return 使い回せるならtrue
+		*/
+		bool Reusable(TDXScene::FillSettings const & settings) const;
+
+		//! A private member function.
+		/*!
+			カメラの位置をセットする
+		*/
+		void SetCamera();
+
+		//! A private static member function.
+		/*!
+			SimpleVertex2に位置と色をセットする
+			\param x x座標
+			\param y y座標
+			\param z z座標
+			\param sign 波動関数の符号
+			\param ver 対象のSimpleVertex2
+		*/
+		static void SetSimpleVertex2(double x, double y, double z, std::int32_t sign, SimpleVertex2 & ver);
+
+		//! A private member function.
+		/*!
+			詰め終わった点から、マルコフ連鎖と重み付きの統計量を求める
+		*/
+		void StoreStatistics();
+
+		//! A private member function.
+		/*!
+			生成した点をブルーノイズな部分集合に間引き、頂点バッファの先頭に詰める
+			中止が要求されたら、間引いた点を詰めずに（均一さも更新せずに）抜ける
+			\param target 間引いた後の点の数
+			\return 最後まで間引いたかどうか
+		*/
+		bool ThinVertices(std::vector<SimpleVertex2>::size_type target);
+
+		//! A private member function (const).
+		/*!
+			点(x, y, z)における目的の分布の値を返す（波動関数の場合は符号付き）
+			\param x x座標
+			\param y y座標
+			\param z z座標
+			\return 目的の分布の値（メッシュの外側では0）
+		*/
+		double Target(double x, double y, double z) const;
+
+		//! A private member function (const).
+		/*!
+			(cosθ, φ)での、描画する球面調和関数の値を返す（表を使う場合は表から補間する）
+			\param costheta cosθ
+			\param phi φ
+			\return 球面調和関数の値
+		*/
+		double YlmAngles(double costheta, double phi) const;
+
+		//! A private member function (const).
+		/*!
+			単位ベクトルの方向での、描画する球面調和関数の値を返す（再描画ごとに選んだ関数を分岐せずに呼ぶ）
+			\param ux 単位ベクトルのx成分
+			\param uy 単位ベクトルのy成分
+			\param uz 単位ベクトルのz成分
+			\return 球面調和関数の値
+		*/
+		double YlmCartesian(double ux, double uy, double uz) const
+		{
+			return ylm_(ux, uy, uz);
+		}
+
+		// #endregion メンバ関数
+
+		// #region プロパティ
+
+	public:
+		//! A property.
+		/*!
+			棄却法の採択率へのプロパティ
+		*/
+		utility::Property<double> const Acceptance;
+
+		//! A property.
+		/*!
+			角度部分に表を使うかどうかへのプロパティ（BATCH、EXACT、VOXEL、MCMCでは使わない）
+		*/
+		utility::Property<bool> Angulartable;
+
+		//! A property.
+		/*!
+			角度部分の表の使うメモリの量（バイト、表を使わない場合は0）へのプロパティ
+		*/
+		utility::Property<std::size_t> const Angulartablebytes;
+
+		//! A property.
+		/*!
+			角度部分の表の、補間の最大誤差（格子点での最大値に対する比）へのプロパティ
+		*/
+		utility::Property<double> const Angulartableerror;
+
+		//! A property.
+		/*!
+			角度部分の表のθ方向の区間の数（φ方向はその2倍）へのプロパティ
+		*/
+		utility::Property<std::int32_t> Angulartablesize;
+
+		//! A property.
+		/*!
+			生成された点の積分自己相関時間へのプロパティ（独立に生成するモードでは1）
+		*/
+		utility::Property<double> const Autocorrtime;
+
+		//! A property.
+		/*!
+			描画スレッドの作業が完了したかどうかへのプロパティ
+		*/
+		utility::Property<bool> const Complete;
+
+		//! A property.
+		/*!
+			描画する頂点数へのプロパティ（間引いた場合は間引いた後の点の数）
+		*/
+		utility::Property<std::vector<SimpleVertex2>::size_type> const Drawsize;
+
+		//! A property.
+		/*!
+			有効サンプル数の頂点数に対する比へのプロパティ（重みのないモードでは1）
+		*/
+		utility::Property<double> const Essratio;
+
+		//! A property.
+		/*!
+			最後に渡した描画のジョブの完了を表すstd::futureへのプロパティ
+		*/
+		utility::Property<std::future<void> const &> const Fill;
+
+		//! A property.
+		/*!
+			角度部分の表の補間の方法へのプロパティ
+		*/
+		utility::Property<sampler::AngularTable::Interpolation_type> Interpolation;
+
+		//! A property.
+		/*!
+			再描画の要求から最初の点を詰め始めるまでの時間（秒）へのプロパティ
+		*/
+		utility::Property<double> const Latency;
+
+		//! A property.
+		/*!
+			生成された点の重み付きの<r>へのプロパティ
+		*/
+		utility::Property<double> const Meanr;
+
+		//! A property.
+		/*!
+			データオブジェクトのスマートポインタのプロパティ
+		*/
+		utility::Property<std::shared_ptr<getdata::GetData>> Pgd;
+
+		//! A property.
+		/*!
+			VertexLayoutのスマートポインタのプロパティ
+		*/
+		utility::Property<std::shared_ptr<ID3D10InputLayout> const &> const PInputLayout;
+
+		//! A property.
+		/*!
+			再描画の要求から最初の段階の点を描画できるようになるまでの時間（秒）へのプロパティ
+		*/
+		utility::Property<double> const Previewtime;
+
+		//! A property.
+		/*!
+			再描画するかどうかへのプロパティ
+		*/
+		utility::Property<bool> Redraw;
+
+		//! A property.
+		/*!
+			詰めている途中で中止された再描画の数へのプロパティ
+		*/
+		utility::Property<std::uint64_t> const Redrawcancelled;
+
+		//! A property.
+		/*!
+			自分の描画が始まる前に、後の要求にまとめられた再描画の要求の数へのプロパティ
+		*/
+		utility::Property<std::uint64_t> const Redrawcoalesced;
+
+		//! A property.
+		/*!
+			最後まで詰め終わった再描画の数へのプロパティ
+		*/
+		utility::Property<std::uint64_t> const Redrawcompleted;
+
+		//! A property.
+		/*!
+			再描画の要求の数へのプロパティ
+		*/
+		utility::Property<std::uint64_t> const Redrawrequested;
+
+		//! A property.
+		/*!
+			ワーカースレッドに渡した再描画のジョブの数へのプロパティ
+		*/
+		utility::Property<std::uint64_t> const Redrawsubmitted;
+
+		//! A property.
+		/*!
+			頂点数だけを変えた再描画を要求するプロパティ（条件が前回と同じなら、生成済みの点を使い回して差分だけを詰める）
+		*/
+		utility::Property<bool> Resize;
+
+		//! A property.
+		/*!
+			サンプリング手法へのプロパティ
+		*/
+		utility::Property<TDXScene::Sampling_type> Sampling;
+
+		//! A property.
+		/*!
+			サンプリングの前処理にかかった時間（秒）へのプロパティ
+		*/
+		utility::Property<double> const Setuptime;
+
+		//! A property.
+		/*!
+			棄却法の試行のうち、角度部分の上限との比較で（スプラインを評価せずに）棄却されたものの割合へのプロパティ
+		*/
+		utility::Property<double> const Squeezeangular;
+
+		//! A property.
+		/*!
+			棄却法の試行のうち、動径部分の上限との比較で（球面調和関数もスプラインも評価せずに）棄却されたものの割合へのプロパティ
+		*/
+		utility::Property<double> const Squeezeradial;
+
+		//! A property.
+		/*!
+			描画の中止を要求してから、ワーカースレッドが描画をやめるまでの時間（秒）へのプロパティ
+		*/
+		utility::Property<double> const Stoplatency;
+
+		//! A property.
+		/*!
+			スレッドを強制終了するかどうかへのプロパティ
+		*/
+		utility::Property<bool> Thread_end;
+
+		//! A property.
+		/*!
+			ブルーノイズに間引いた後の点の数へのプロパティ（0なら間引かない）
+		*/
+		utility::Property<std::vector<SimpleVertex2>::size_type> Thinningtarget;
+
+		//! A property.
+		/*!
+			間引くのにかかった時間（秒）へのプロパティ
+		*/
+		utility::Property<double> const Thinningtime;
+
+		//! A property.
+		/*!
+			間引いた後の点の、規格化した最近接距離の変動係数へのプロパティ（小さいほど均一）
+		*/
+		utility::Property<double> const Uniformity;
+
+		//! A property.
+		/*!
+			間引く前の点から同じ数だけ取った部分集合の、規格化した最近接距離の変動係数へのプロパティ
+		*/
+		utility::Property<double> const Uniformitybefore;
+
+		//! A property.
+		/*!
+			頂点数へのプロパティ
+		*/
+		utility::Property<std::vector<SimpleVertex2>::size_type> Vertexsize;
+
+		// #endregion プロパティ
+
+		// #region メンバ変数
+
+	public:
+		//! A public static member variable (constant).
+		/*!
+			頂点の初期値
+		*/
+		static std::vector<SimpleVertex2>::size_type const VERTEXSIZE_FIRST = 100000;
+
+		//! A public static member variable (constant).
+		/*!
+			角度部分の表のθ方向の区間の数の初期値
+		*/
+		static std::int32_t const ANGULARTABLESIZE_FIRST = 128;
+
+		//! A public static member variable (constant).
+		/*!
+			描画範囲rmaxの内側に入る、描画する点の割合
+		*/
+		static double const ENCLOSED_PROBABILITY;
+
+	private:
+		//! A private static member variable (constant).
+		/*!
+			点を詰めるタスク一つあたりの頂点数の上限（タスクの合間に中止を確かめる）
+		*/
+		static std::int32_t const FILLGRAIN = 256;
+
+		//! A private static member variable (constant).
+		/*!
+			カメラの位置の倍率
+		*/
+		static float const MAGNIFICATION;
+
+		//! A private static member variable (constant).
+		/*!
+			最初に描画する段階の頂点数
+		*/
+		static std::int32_t const PREVIEWSIZE = 10000;
+
+		//! A private static member variable (constant).
+		/*!
+			段階ごとに頂点数を増やす倍率
+		*/
+		static std::int32_t const PREVIEWRATIO = 10;
+
+		//! A private static member variable (constant).
+		/*!
+			動径方向の殻の数
+		*/
+		static std::size_t const NSHELL = 512;
+
+		//! A private static member variable (constant).
+		/*!
+			マルコフ連鎖のバーンインで捨てるステップ数
+		*/
+		static std::int32_t const MCMC_BURNIN = 2000;
+
+		//! A private static member variable (constant).
+		/*!
+			マルコフ連鎖で出力する点の間に進めるステップ数
+		*/
+		static std::int32_t const MCMC_THIN = 5;
+
+		//! A private static member variable (constant).
+		/*!
+			ボクセル格子の一辺あたりのボクセルの数
+		*/
+		static std::int32_t const NVOXEL = 32;
+
+		//! A private static member variable (constant).
+		/*!
+			層別サンプリングの、動径方向の殻の数
+		*/
+		static std::size_t const NSTRATUMSHELL = 64;
+
+		//! A private static member variable (constant).
+		/*!
+			層別サンプリングの、φ方向のセルの数
+		*/
+		static std::size_t const NSTRATUMPHI = 64;
+
+		//! A private static member variable (constant).
+		/*!
+			層別サンプリングの、cosθ方向のセルの数
+		*/
+		static std::size_t const NSTRATUMTHETA = 32;
+
+		//! A private member variable.
+		/*!
+			採択された点の数
+		*/
+		std::atomic<std::uint64_t> accepted_;
+
+		//! A private member variable.
+		/*!
+			角度部分の分布の上限（安全係数込み）
+		*/
+		double angularmax_ = 0.0;
+
+		//! A private member variable.
+		/*!
+			角度部分に表を使うかどうか
+		*/
+		std::atomic<bool> angulartable_ = false;
+
+		//! A private member variable.
+		/*!
+			角度部分の表の使うメモリの量（バイト）
+		*/
+		std::atomic<std::size_t> angulartablebytes_;
+
+		//! A private member variable.
+		/*!
+			角度部分の表の、補間の最大誤差（格子点での最大値に対する比）
+		*/
+		std::atomic<double> angulartableerror_;
+
+		//! A private member variable.
+		/*!
+			角度部分の表を作った時の(l, m, sine, 区間の数, 補間の方法)（同じなら表を作り直さない）
+		*/
+		std::tuple<std::uint32_t, std::int32_t, bool, std::int32_t, sampler::AngularTable::Interpolation_type> angulartablekey_;
+
+		//! A private member variable.
 		/*!
-			唯一のコンストラクタ
+			角度部分の表のθ方向の区間の数
 		*/
-		explicit TDXScene(std::shared_ptr<getdata::GetData> const & pgd);
+		std::atomic<std::int32_t> angulartablesize_ = ANGULARTABLESIZE_FIRST;
 
-		//! A destructor.
+		//! A private member variable.
 		/*!
-		デストラクタ
+			生成された点の積分自己相関時間
 		*/
-		~TDXScene() = default;
+		std::atomic<double> autocorrtime_;
 
-		// #endregion コンストラクタ・デストラクタ
+		//! A private member variable.
+		/*!
+			角度部分のサンプラー
+		*/
+		std::unique_ptr<sampler::AngularSampler> pangularsampler_;
 
-		// #region メンバ関数
+		//! A private member variable.
+		/*!
+			角度部分の表（再描画をまたいでキャッシュする）
+		*/
+		std::unique_ptr<sampler::AngularTable> pangulartable_;
 
-		//! A public member function.
+		//! A private member variable.
 		/*!
-			Direct3Dデバイスを初期化する
-			\param Direct3Dデバイスへのポインタ
-			\return 初期化が成功したかどうか
+			SIMD化された棄却法のカーネル
 		*/
-		HRESULT Init(ID3D10Device* pd3dDevice);
+		std::unique_ptr<sampler::BatchRejection> pbatchrejection_;
 
-		LRESULT MsgPrc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+		//! A private member variable.
+		/*!
+			デカルト座標の多項式で表した球面調和関数（l ≦ 4の場合）
+		*/
+		std::unique_ptr<sampler::CartesianYlm> pcartesianylm_;
 
-		HRESULT OnFrameMove(double fTime, float fElapsedTime, void* pUserContext);
-		HRESULT OnRender(ID3D10Device* pd3dDevice, double fTime, float fElapsedTime, void* pUserContext);
-		HRESULT OnResize(ID3D10Device* pd3dDevice, IDXGISwapChain* pSwapChain,
-			const DXGI_SURFACE_DESC* pBackBufferSurfaceDesc, void* pUserContext);
+		//! A private member variable.
+		/*!
+			Legendre陪関数の漸化式による球面調和関数（l > 4の場合）
+		*/
+		std::unique_ptr<sampler::YlmLadder> pylmladder_;
 
-		//! A public member function.
+		//! A private member variable.
 		/*!
-			再描画する
-			\param m 磁気量子数
-			\param pd3dDevice DirectXデバイスへのスマートポインタ
-			\param reim 実部を描画するか、虚部を描画するか
-			\return 再描画が成功したかどうか
+			バッファー リソース
 		*/
-		HRESULT RedrawFunc(std::int32_t m, ID3D10Device * pd3dDevice, TDXScene::Re_Im_type reim);
+		D3D10_BUFFER_DESC bd_;
 
-	private:
-		//! A private member function.
+		//! A private member variable.
 		/*!
-			SimpleVertex2のデータをクリアし、新しいデータを詰める
-			\param m 磁気量子数
-			\param reim 実部を描画するか、虚部を描画するか
-			\param ver 対象のSimpleVertex2
+			頂点バッファに入っている頂点数（描画スレッドだけが使う）
 		*/
-		void ClearFillSimpleVertex2(std::int32_t m, TDXScene::Re_Im_type reim);
+		std::vector<SimpleVertex2>::size_type buffersize_ = 0;
 
-		//! A private member function.
+		//! A private member variable.
 		/*!
-			SimpleVertex2にデータを詰める
-			\param m 磁気量子数
-			\param reim 実部を描画するか、虚部を描画するか
-			\param ver 対象のSimpleVertex2
+			頂点バッファに入る頂点数（描画スレッドだけが使う）
 		*/
-		void FillSimpleVertex2(std::int32_t m, TDXScene::Re_Im_type reim, SimpleVertex2 & ver);
+		std::vector<SimpleVertex2>::size_type buffercapacity_ = 0;
 
-		//! A private member function.
+		//! A private member variable.
 		/*!
-			カメラの位置をセットする
+			A model viewing camera
 		*/
-		void SetCamera();
+		CModelViewerCamera camera_;
 
-		// #endregion メンバ関数
+		//! A private member variable.
+		/*!
+			描画スレッドの作業が完了したかどうか
+		*/
+		std::atomic<bool> complete_;
 
-		// #region プロパティ
+		//! A private member variable.
+		/*!
+			実行中のジョブが点を詰める並列処理のタスクグループ（中止が要求されると、まだ始まっていないタスクは実行されない）
+			タスクグループはジョブごとに作り、ジョブが実行している間だけcontextmutex_の下で指す
+		*/
+		tbb::task_group_context * pcontext_ = nullptr;
 
-	public:
-		//! A property.
+		//! A private member variable.
 		/*!
-			描画スレッドの作業が完了したかどうかへのプロパティ
+			pcontext_の差し替えと、それが指すタスクグループの中止を排他するミューテックス
 		*/
-		utility::Property<bool> const Complete;
+		std::mutex contextmutex_;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			スレッドへのスマートポインタのプロパティ
+			描画する頂点数
 		*/
-		utility::Property<std::shared_ptr<std::thread> const &> const Pth;
+		std::atomic<std::vector<SimpleVertex2>::size_type> drawsize_ = VERTEXSIZE_FIRST;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			データオブジェクトのスマートポインタのプロパティ
+			頂点バッファへまだ転送していない頂点の範囲の先頭（ワーカースレッドは下げるだけで、描画スレッドは転送したら描画する頂点数まで上げる）
 		*/
-		utility::Property<std::shared_ptr<getdata::GetData>> Pgd;
+		std::atomic<std::vector<SimpleVertex2>::size_type> dirtyfirst_;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			VertexLayoutのスマートポインタのプロパティ
+			目的の分布の上限（安全係数込み）
 		*/
-		utility::Property<std::shared_ptr<ID3D10InputLayout> const &> const PInputLayout;
+		double envelope_ = 0.0;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			再描画するかどうかへのプロパティ
+			包絡線を超えた試行の回数（デバッグ用）
 		*/
-		utility::Property<bool> Redraw;
+		std::atomic<std::uint64_t> envelopeover_;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			スレッドを強制終了するかどうかへのプロパティ
+			有効サンプル数の頂点数に対する比
 		*/
-		utility::Property<bool> Thread_end;
+		std::atomic<double> essratio_;
 
-		//! A property.
+		//! A private member variable.
 		/*!
-			頂点数へのプロパティ
+			エフェクト＝シェーダプログラムを読ませるところ
 		*/
-		utility::Property<std::vector<SimpleVertex2>::size_type> Vertexsize;
+		std::unique_ptr<ID3D10Effect, utility::Safe_Release<ID3D10Effect>> effect_;
 
-		// #endregion プロパティ
+		//! A private member variable.
+		/*!
+			最後に渡した描画のジョブの完了を表すstd::future
+		*/
+		std::future<void> fill_;
 
-		// #region メンバ変数
+		//! A private member variable.
+		/*!
+			最後まで詰め終わった点を生成したときの条件（磁気量子数、実部か虚部か、サンプリングの手法と角度部分の表の設定）
+		*/
+		std::tuple<getdata::GetData const *, std::int32_t, TDXScene::Re_Im_type, TDXScene::Sampling_type, bool, std::int32_t, sampler::AngularTable::Interpolation_type> fillkey_;
 
-	public:
-		//! A public static member variable (constant).
+		//! A private member variable.
 		/*!
-			頂点の初期値
+			最後まで詰め終わって使い回せる頂点の数（ワーカースレッドだけが使う）
 		*/
-		static std::vector<SimpleVertex2>::size_type const VERTEXSIZE_FIRST = 100000;
+		std::vector<SimpleVertex2>::size_type filled_ = 0;
 
-	private:
-		//! A private static member variable (constant).
+		//! A private member variable.
 		/*!
-			カメラの位置の倍率
+			再描画の要求の通し番号（古い要求のジョブは、始まる前にこれを見て何もせずに終わる）
 		*/
-		static float const MAGNIFICATION;
+		std::atomic<std::uint64_t> generation_;
 
 		//! A private member variable.
 		/*!
-			バッファー リソース
+			詰めている途中の点もそのまま描画しているかどうか（層別サンプリングと重み付きの点）
 		*/
-		D3D10_BUFFER_DESC bd_;
+		std::atomic<bool> inplace_ = false;
 
 		//! A private member variable.
 		/*!
-			A model viewing camera
+			角度部分の表の補間の方法
 		*/
-		CModelViewerCamera camera_;
+		std::atomic<sampler::AngularTable::Interpolation_type> interpolation_ = sampler::AngularTable::Interpolation_type::BILINEAR;
 
 		//! A private member variable.
 		/*!
-			描画スレッドの作業が完了したかどうか
+			再描画の要求から最初の点を詰め始めるまでの時間（秒）
 		*/
-		std::atomic<bool> complete_;
+		std::atomic<double> latency_;
 
 		//! A private member variable.
 		/*!
-			エフェクト＝シェーダプログラムを読ませるところ
+			生成された点の重み付きの<r>
 		*/
-		std::unique_ptr<ID3D10Effect, utility::Safe_Release<ID3D10Effect>> effect_;
+		std::atomic<double> meanr_;
 
 		//! A private member variable.
 		/*!
@@ -238,9 +1021,9 @@ namespace tdxscene {
 
 		//! A private member variable.
 		/*!
-			スレッドへのスマートポインタ
+			点を詰めるジョブを実行する常駐のワーカースレッド
 		*/
-		std::shared_ptr<std::thread> pth_;
+		std::unique_ptr<utility::WorkerService> pworker_;
 
 		//! A private member variable.
 		/*!
@@ -248,18 +1031,132 @@ namespace tdxscene {
 		*/
 		std::shared_ptr<getdata::GetData> pgd_;
 
+		//! A private member variable.
+		/*!
+			再描画の要求から最初の段階の点を描画できるようになるまでの時間（秒）
+		*/
+		std::atomic<double> previewtime_;
+
+		//! A private member variable.
+		/*!
+			スレッドごとの低食い違い量列のストリーム
+		*/
+		myrandom::QmcStreams qmcstreams_;
+
+		//! A private member variable.
+		/*!
+			スレッドごとの乱数ストリーム
+		*/
+		myrandom::MyRandStreams randstreams_;
+
+		//! A private member variable.
+		/*!
+			動径方向の殻ごとの包絡線
+		*/
+		std::unique_ptr<sampler::RadialShells> pradialshells_;
+
+		//! A private member variable.
+		/*!
+			区間ごとの動径部分の上限（棄却法の前段で使う）
+		*/
+		std::unique_ptr<sampler::RadialBound> pradialbound_;
+
 		//! A private member variable.
 		/*!
 			再描画するかどうか
 		*/
 		bool redraw_ = true;
 
+		//! A private member variable.
+		/*!
+			詰めている途中で中止された再描画の数
+		*/
+		std::atomic<std::uint64_t> redrawcancelled_;
+
+		//! A private member variable.
+		/*!
+			自分の描画が始まる前に、後の要求にまとめられた再描画の要求の数（ワーカースレッドで置き換えられたジョブの分は含まない）
+		*/
+		std::atomic<std::uint64_t> redrawcoalesced_;
+
+		//! A private member variable.
+		/*!
+			最後まで詰め終わった再描画の数
+		*/
+		std::atomic<std::uint64_t> redrawcompleted_;
+
+		//! A private member variable.
+		/*!
+			再描画の要求の数
+		*/
+		std::atomic<std::uint64_t> redrawrequested_;
+
+		//! A private member variable.
+		/*!
+			実行中のジョブの再描画が要求された時刻（ワーカースレッドだけが使う）
+		*/
+		tbb::tick_count redrawstart_;
+
+		//! A private member variable.
+		/*!
+			次の再描画で、生成済みの点を使い回してよいかどうか
+		*/
+		bool reuse_ = false;
+
+		//! A private member variable.
+		/*!
+			rmaxにおける動径分布の累積分布関数の値
+		*/
+		double radialcdfmax_ = 1.0;
+
+		//! A private member variable.
+		/*!
+			描画するのが電子密度かどうか（再描画ごとに一度だけ求める）
+		*/
+		bool rho_ = false;
+
 		//! A private member variable.
 		/*!
 			描画するrの最大値
 		*/
 		double rmax_;
 
+		//! A private member variable.
+		/*!
+			サンプリング手法（ジョブは、渡された時にFillSettingsへ写した値だけを使う）
+		*/
+		std::atomic<TDXScene::Sampling_type> sampling_ = TDXScene::Sampling_type::REJECTION;
+
+		//! A private member variable.
+		/*!
+			サンプリングの前処理にかかった時間（秒）
+		*/
+		std::atomic<double> setuptime_;
+
+		//! A private member variable.
+		/*!
+			角度部分の上限との比較で棄却された試行の回数
+		*/
+		std::atomic<std::uint64_t> squeezeangular_;
+
+		//! A private member variable.
+		/*!
+			動径部分の上限との比較で棄却された試行の回数
+		*/
+		std::atomic<std::uint64_t> squeezeradial_;
+
+		//! A private member variable.
+		/*!
+			重み付きの点を生成する時に、頂点の添字から動径分布の層を選ぶための歩幅（頂点数と互いに素）
+		*/
+		std::int32_t stratumstride_ = 1;
+
+		//! A private member variable.
+		/*!
+			描画の中止を要求してから、ワーカースレッドが描画をやめるまでの時間（秒）
+		*/
+		std::atomic<double> stoplatency_;
+
 		//! A private member variable.
 		/*!
 			テクニック情報
@@ -272,6 +1169,42 @@ namespace tdxscene {
 		*/
 		std::atomic<bool> thread_end_ = false;
 
+		//! A private member variable.
+		/*!
+			ブルーノイズに間引いた後の点の数（0なら間引かない）
+		*/
+		std::atomic<std::vector<SimpleVertex2>::size_type> thinningtarget_ = 0;
+
+		//! A private member variable.
+		/*!
+			間引くのにかかった時間（秒）
+		*/
+		std::atomic<double> thinningtime_;
+
+		//! A private member variable.
+		/*!
+			棄却法の試行回数
+		*/
+		std::atomic<std::uint64_t> trials_;
+
+		//! A private member variable.
+		/*!
+			間引いた後の点の、規格化した最近接距離の変動係数
+		*/
+		std::atomic<double> uniformity_;
+
+		//! A private member variable.
+		/*!
+			間引く前の点から同じ数だけ取った部分集合の、規格化した最近接距離の変動係数
+		*/
+		std::atomic<double> uniformitybefore_;
+
+		//! A private member variable.
+		/*!
+			今回の再描画で角度部分の表を使うかどうか
+		*/
+		bool useangulartable_ = false;
+
 		//! A private member variable.
 		/*!
 			頂点バッファ
@@ -284,6 +1217,24 @@ namespace tdxscene {
 		*/
 		std::shared_ptr<ID3D10InputLayout> pInputLayout_;
 
+		//! A private member variable.
+		/*!
+			ボクセル格子
+		*/
+		std::unique_ptr<sampler::VoxelGrid> pvoxelgrid_;
+
+		//! A private member variable.
+		/*!
+			層別サンプリングの層と、層ごとの点の数
+		*/
+		std::unique_ptr<sampler::Strata> pstrata_;
+
+		//! A private member variable.
+		/*!
+			ワーカースレッドごとのマルコフ連鎖
+		*/
+		std::unique_ptr<tbb::enumerable_thread_specific<sampler::MetropolisChain>> pchains_;
+
 		//! A private member variable.
 		/*!
 			頂点数
@@ -296,6 +1247,12 @@ namespace tdxscene {
 		*/
 		std::vector<SimpleVertex2> vertices_;
 
+		//! A private member variable.
+		/*!
+			vertices_の作り直しと、頂点バッファへの転送を排他するミューテックス
+		*/
+		std::mutex verticesmutex_;
+
 		//! A private member variable.
 		/*!
 			ビュー変換行列
@@ -307,6 +1264,12 @@ namespace tdxscene {
 		*/
 		ID3D10EffectMatrixVariable * viewVariable_;
 
+		//! A private member variable.
+		/*!
+			頂点ごとの重み
+		*/
+		std::vector<double> weights_;
+
 		//! A private member variable.
 		/*!
 			ワールド変換行列
@@ -315,6 +1278,18 @@ namespace tdxscene {
 
 		ID3D10EffectMatrixVariable * worldVariable_;
 
+		//! A private member variable.
+		/*!
+			描画する(l, m, reim)の球面調和関数を、単位ベクトルから求める関数（再描画ごとに一度だけ選ぶ）
+		*/
+		std::function<double(double, double, double)> ylm_;
+
+		//! A private member variable.
+		/*!
+			描画する波動関数が恒等的に0かどうか（虚部でm = 0の場合。再描画ごとに一度だけ求める）
+		*/
+		bool zero_ = false;
+
 		// #region 禁止されたコンストラクタ・メンバ関数
 
 		//! A private constructor (deleted).
@@ -342,11 +1317,12 @@ namespace tdxscene {
 
 	//! A function.
 	/*!
-		データオブジェクトからrmaxを求める
+		データオブジェクトから、描画する点のうちprobabilityの割合を含む半径rmaxを求める
 		\param pgd データオブジェクト
+		\param probability rmaxの内側に入る点の割合
 		\return rmaxの値
 	*/
-	double GetRmax(std::shared_ptr<getdata::GetData> const & pgd);
+	double GetRmax(std::shared_ptr<getdata::GetData> const & pgd, double probability);
 }
 
 #endif  // _TDXSCENE_H_
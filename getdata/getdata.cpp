@@ -8,8 +8,11 @@ This software is released under the BSD 2-Clause License.
 #include "DXUT.h"
 #include "getdata.h"
 #include "readdatafile.h"
+#include <algorithm>                    // for std::max, std::upper_bound
+#include <cmath>                        // for std::fabs
 #include <stdexcept>                    // for std::runtime_error
 #include <tuple>                        // for std::tie
+#include <utility>                      // for std::move
 #include <boost/algorithm/string.hpp>   // for boost::algorithm
 #include <boost/assert.hpp>             // for BOOST_ASSERT
 #include <boost/cast.hpp>               // for boost::cast
@@ -27,7 +30,7 @@ namespace getdata {
         Orbital([this] { return orbital_; }, nullptr),
         Rho_wf_type_([this] { return rho_wf_type_; }, nullptr),
         R_meshmin([this] { return r_meshmin_; }, nullptr),
-        acc_(gsl_interp_accel_alloc(), gsl_interp_accel_deleter)
+        R_meshmax([this] { return r_mesh_.back(); }, nullptr)
     {
         using namespace boost::algorithm;
 
@@ -102,10 +105,25 @@ namespace getdata {
 
         r_meshmin_ = r_mesh[0];
 
-        spline_ = std::unique_ptr<gsl_spline, decltype(gsl_spline_deleter)>(
-            gsl_spline_alloc(gsl_interp_cspline, r_mesh.size()), gsl_spline_deleter);
+        spline_.reset(new LogMeshSpline(r_mesh, phi));
 
-        gsl_spline_init(spline_.get(), r_mesh.data(), phi.data(), r_mesh.size());
+        // 動径分布r^2|f(r)|を台形公式で積分して累積分布関数のテーブルを作る
+        radialcdf_.assign(r_mesh.size(), 0.0);
+        for (auto i = 1U; i < r_mesh.size(); i++) {
+            auto const w0 = r_mesh[i - 1] * r_mesh[i - 1] * std::fabs(phi[i - 1]);
+            auto const w1 = r_mesh[i] * r_mesh[i] * std::fabs(phi[i]);
+            radialcdf_[i] = radialcdf_[i - 1] + 0.5 * (w0 + w1) * (r_mesh[i] - r_mesh[i - 1]);
+        }
+
+        auto const total = radialcdf_.back();
+        if (total <= 0.0) {
+            throw std::runtime_error("データファイルが異常です！");
+        }
+
+        boost::for_each(radialcdf_, [total](double & v) { v /= total; });
+
+        func_ = std::move(phi);
+        r_mesh_ = std::move(r_mesh);
     }
 
     // #endregion コンストラクタ
@@ -114,7 +132,62 @@ namespace getdata {
 
     double GetData::operator()(double r) const
     {
-        return gsl_spline_eval(spline_.get(), r, acc_.get());
+        return (*spline_)(r);
+    }
+
+    void GetData::operator()(std::size_t n, double const * r, double * f, double * df) const
+    {
+        spline_->Evaluate(n, r, f, df);
+    }
+
+    double GetData::AbsMax(double rmin, double rmax) const
+    {
+        auto absmax = 0.0;
+
+        // rminとrmaxを挟むメッシュ点まで含めて走査する
+        auto const first = std::upper_bound(r_mesh_.begin(), r_mesh_.end(), rmin);
+        auto const last = std::upper_bound(r_mesh_.begin(), r_mesh_.end(), rmax);
+        auto const ifirst = first == r_mesh_.begin() ? 0 : (first - r_mesh_.begin()) - 1;
+        auto const ilast = last == r_mesh_.end() ? r_mesh_.end() - r_mesh_.begin() : (last - r_mesh_.begin()) + 1;
+
+        for (auto i = ifirst; i < ilast; i++) {
+            absmax = std::max(absmax, std::fabs(func_[i]));
+        }
+
+        return absmax;
+    }
+
+    double GetData::RadialCdf(double r) const
+    {
+        if (r <= r_mesh_.front()) {
+            return 0.0;
+        }
+        else if (r >= r_mesh_.back()) {
+            return 1.0;
+        }
+
+        // r_mesh_[i] <= r < r_mesh_[i + 1]となるiを、スプラインと同じ方法で求める
+        auto const i = spline_->Index(r);
+        auto const t = (r - r_mesh_[i]) / (r_mesh_[i + 1] - r_mesh_[i]);
+
+        return radialcdf_[i] + t * (radialcdf_[i + 1] - radialcdf_[i]);
+    }
+
+    double GetData::RadialInvCdf(double u) const
+    {
+        if (u <= 0.0) {
+            return r_mesh_.front();
+        }
+        else if (u >= 1.0) {
+            return r_mesh_.back();
+        }
+
+        // radialcdf_[i - 1] <= u < radialcdf_[i]となるiを二分探索で求める
+        auto const i = static_cast<std::size_t>(std::upper_bound(radialcdf_.begin(), radialcdf_.end(), u) - radialcdf_.begin());
+        auto const du = radialcdf_[i] - radialcdf_[i - 1];
+        auto const t = du > 0.0 ? (u - radialcdf_[i - 1]) / du : 0.0;
+
+        return r_mesh_[i - 1] + t * (r_mesh_[i] - r_mesh_[i - 1]);
     }
 
     // #endsregion メンバ関数
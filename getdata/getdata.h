@@ -10,11 +10,13 @@ This software is released under the BSD 2-Clause License.
 
 #pragma once
 
-#include "deleter.h"
+#include "logmeshspline.h"
 #include "../utility/property.h"
+#include <cstddef>      // for std::size_t
 #include <cstdint>      // for std::int32_t, std::uint32_t
 #include <memory>       // for std::unique_ptr
 #include <string>       // for std::string
+#include <vector>       // for std::vector
 
 namespace getdata {
     using namespace utility;
@@ -67,6 +69,41 @@ namespace getdata {
         */
         double operator()(double r) const;
 
+        //!  A public member function (const).
+        /*!
+        n個のrについて、関数の値（と、必要なら1階微分）をまとめて求める
+        \param n rの個数
+        \param r rの配列
+        \param f 関数の値の出力先
+        \param df 1階微分の出力先（nullptrなら求めない）
+        */
+        void operator()(std::size_t n, double const * r, double * f, double * df = nullptr) const;
+
+        //!  A public member function (const).
+        /*!
+        [rmin, rmax]の範囲での関数の絶対値の最大値を返す
+        \param rmin rの下限
+        \param rmax rの上限
+        \return 関数の絶対値の最大値
+        */
+        double AbsMax(double rmin, double rmax) const;
+
+        //!  A public member function (const).
+        /*!
+        動径分布r^2|f(r)|の累積分布関数の値を返す
+        \param r rの値
+        \return 累積分布関数の値（[0.0, 1.0]に規格化されている）
+        */
+        double RadialCdf(double r) const;
+
+        //!  A public member function (const).
+        /*!
+        動径分布r^2|f(r)|の累積分布関数の逆関数の値を返す
+        \param u 累積分布関数の値（[0.0, 1.0]）
+        \return uに対応するrの値
+        */
+        double RadialInvCdf(double u) const;
+
         // #endregion メンバ関数
 
         // #region プロパティ
@@ -119,22 +156,28 @@ namespace getdata {
         */
         Property<double> const R_meshmin;
 
+        //! A property.
+        /*!
+			rのメッシュの最大値のプロパティ
+        */
+        Property<double> const R_meshmax;
+
         // #endregion プロパティ
 
         // #region メンバ変数
 
     private:
-        //! A private member variable.
+        //!  A private member variable.
         /*!
-        gsl_interp_accelへのスマートポインタ
+        元素名
         */
-        std::unique_ptr<gsl_interp_accel, decltype(gsl_interp_accel_deleter)> const acc_;
+        std::string atomname_;
 
         //!  A private member variable.
         /*!
-        元素名
+        rのメッシュにおける関数の値
         */
-        std::string atomname_;
+        std::vector<double> func_;
 
         //!  A private member variable.
         /*!
@@ -178,11 +221,23 @@ namespace getdata {
         */
         double r_meshmin_;
 
+        //!  A private member variable.
+        /*!
+        動径分布の累積分布関数のテーブル（rのメッシュ上の値）
+        */
+        std::vector<double> radialcdf_;
+
+        //!  A private member variable.
+        /*!
+        rのメッシュ
+        */
+        std::vector<double> r_mesh_;
+
         //! A private member variable.
         /*!
-        gsl_interp_typeへのスマートポインタ
+        関数の3次スプライン補間へのスマートポインタ（複数のスレッドから同時に評価してよい）
         */
-        std::unique_ptr<gsl_spline, decltype(gsl_spline_deleter)> spline_;
+        std::unique_ptr<LogMeshSpline> spline_;
 
         // #endregion メンバ変数
 
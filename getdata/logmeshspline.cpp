@@ -0,0 +1,179 @@
+﻿/*! \file logmeshspline.cpp
+    \brief 対数メッシュ上の3次スプライン補間を行うクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "logmeshspline.h"
+#include <algorithm>            // for std::max, std::min, std::upper_bound
+#include <cmath>                // for std::fabs, std::log
+#include <cstdint>              // for std::int32_t
+#include <stdexcept>            // for std::runtime_error
+#include <boost/assert.hpp>     // for BOOST_ASSERT
+
+namespace getdata {
+    double const LogMeshSpline::LOGMESH_TOLERANCE = 1.0E-6;
+
+    // #region コンストラクタ
+
+    LogMeshSpline::LogMeshSpline(std::vector<double> const & x, std::vector<double> const & y) :
+        coef_(x.size() - 1),
+        invdx_(0.0),
+        logmesh_(false),
+        logx0_(0.0),
+        x_(x),
+        ylast_(y.back())
+    {
+        BOOST_ASSERT(x.size() == y.size());
+
+        auto const n = x.size();
+        if (n < 3) {
+            throw std::runtime_error("データファイルが異常です！");
+        }
+
+        // 自然境界条件（両端で2階微分が0）の3重対角方程式をThomas法で解いて、2階微分/2（c）を求める
+        std::vector<double> h(n - 1), c(n, 0.0), mu(n, 0.0), z(n, 0.0);
+        for (auto i = 0U; i < n - 1; i++) {
+            h[i] = x[i + 1] - x[i];
+            if (h[i] <= 0.0) {
+                throw std::runtime_error("データファイルが異常です！");
+            }
+        }
+
+        for (auto i = 1U; i < n - 1; i++) {
+            auto const alpha = 3.0 / h[i] * (y[i + 1] - y[i]) - 3.0 / h[i - 1] * (y[i] - y[i - 1]);
+            auto const l = 2.0 * (x[i + 1] - x[i - 1]) - h[i - 1] * mu[i - 1];
+            mu[i] = h[i] / l;
+            z[i] = (alpha - h[i - 1] * z[i - 1]) / l;
+        }
+
+        for (auto i = static_cast<std::int32_t>(n) - 2; i >= 0; i--) {
+            c[i] = z[i] - mu[i] * c[i + 1];
+        }
+
+        // 区間ごとの係数を、評価の時に一度に読めるように並べる
+        for (auto i = 0U; i < n - 1; i++) {
+            coef_[i] = {
+                x[i],
+                y[i],
+                (y[i + 1] - y[i]) / h[i] - h[i] * (c[i + 1] + 2.0 * c[i]) / 3.0,
+                c[i],
+                (c[i + 1] - c[i]) / (3.0 * h[i])
+            };
+        }
+
+        // 隣り合う点の比がすべて等しければ対数メッシュとみなす
+        if (x.front() > 0.0) {
+            auto const dx = std::log(x.back() / x.front()) / static_cast<double>(n - 1);
+            logmesh_ = dx > 0.0;
+            for (auto i = 0U; i < n - 1 && logmesh_; i++) {
+                logmesh_ = std::fabs(std::log(x[i + 1] / x[i]) - dx) <= LOGMESH_TOLERANCE * dx;
+            }
+
+            if (logmesh_) {
+                invdx_ = 1.0 / dx;
+                logx0_ = std::log(x.front());
+            }
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    double LogMeshSpline::operator()(double r) const
+    {
+        if (r <= x_.front()) {
+            return coef_.front()[1];
+        }
+        else if (r >= x_.back()) {
+            return r > x_.back() ? 0.0 : ylast_;
+        }
+
+        auto const & co = coef_[Index(r)];
+        auto const t = r - co[0];
+
+        return co[1] + t * (co[2] + t * (co[3] + t * co[4]));
+    }
+
+    void LogMeshSpline::Evaluate(std::size_t n, double const * r, double * f, double * df) const
+    {
+        double logr[BLOCK];
+
+        for (auto first = 0U; first < n; first += BLOCK) {
+            auto const size = n - first < BLOCK ? n - first : BLOCK;
+            auto const * rb = r + first;
+
+            // 対数だけのループ（依存関係がないのでベクトル化できる）
+            if (logmesh_) {
+                for (auto i = 0U; i < size; i++) {
+                    logr[i] = std::log(std::max(rb[i], x_.front()));
+                }
+            }
+
+            for (auto i = 0U; i < size; i++) {
+                auto const ri = rb[i];
+                // メッシュの端の点ちょうどでは、端の区間の多項式の微分を返す
+                if (ri <= x_.front()) {
+                    f[first + i] = coef_.front()[1];
+                    if (df) {
+                        df[first + i] = ri < x_.front() ? 0.0 : coef_.front()[2];
+                    }
+
+                    continue;
+                }
+                else if (ri >= x_.back()) {
+                    f[first + i] = ri > x_.back() ? 0.0 : ylast_;
+                    if (df) {
+                        auto const & co = coef_.back();
+                        auto const t = ri - co[0];
+                        df[first + i] = ri > x_.back() ? 0.0 : co[2] + t * (2.0 * co[3] + 3.0 * t * co[4]);
+                    }
+
+                    continue;
+                }
+
+                // 対数のメッシュでなければlogr[i]は求めていないので読まない
+                auto const & co = coef_[Index(ri, logmesh_ ? logr[i] : 0.0)];
+                auto const t = ri - co[0];
+
+                f[first + i] = co[1] + t * (co[2] + t * (co[3] + t * co[4]));
+                if (df) {
+                    df[first + i] = co[2] + t * (2.0 * co[3] + 3.0 * t * co[4]);
+                }
+            }
+        }
+    }
+
+    std::size_t LogMeshSpline::Index(double r) const
+    {
+        return Index(r, logmesh_ ? std::log(r) : 0.0);
+    }
+
+    std::size_t LogMeshSpline::Index(double r, double logr) const
+    {
+        auto const last = coef_.size() - 1;
+
+        if (logmesh_) {
+            auto const u = (logr - logx0_) * invdx_;
+            auto i = u > 0.0 ? std::min(static_cast<std::size_t>(u), last) : 0U;
+
+            // 丸め誤差で隣の区間になった場合だけ直す
+            if (i > 0 && r < coef_[i][0]) {
+                i--;
+            }
+            else if (i < last && r >= coef_[i + 1][0]) {
+                i++;
+            }
+
+            return i;
+        }
+
+        auto const i = static_cast<std::size_t>(std::upper_bound(x_.begin(), x_.end(), r) - x_.begin());
+        return i > 0 ? std::min(i - 1, last) : 0U;
+    }
+
+    // #endregion メンバ関数
+}
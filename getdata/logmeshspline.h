@@ -0,0 +1,185 @@
+﻿/*! \file logmeshspline.h
+    \brief 対数メッシュ上の3次スプライン補間を行うクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _LOGMESHSPLINE_H_
+#define _LOGMESHSPLINE_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+namespace getdata {
+    //! A class.
+    /*!
+        自然境界条件の3次スプライン補間を行うクラス（gsl_interp_csplineと同じ補間）
+        Schracの出力するr_i = r_0 exp(i dx)の対数メッシュでは、区間の添字を閉じた式で求める
+        それ以外のメッシュでは二分探索にフォールバックする
+        メッシュの最後の点より外側は0とする（描画範囲rmaxはメッシュの内側に取るので、外側を評価する手法はない）
+        評価はconstで内部状態を持たないので、複数のスレッドから同時に呼んでよい
+    */
+    class LogMeshSpline final {
+        // #region 型エイリアス
+
+    public:
+        //! A typedef.
+        /*!
+            一つの区間の補間の係数（区間の始点x、とf(x + t) = a + t(b + t(c + td))のa, b, c, d）
+        */
+        using coefficient_type = std::array<double, 5>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param x メッシュ（狭義単調増加）
+            \param y メッシュ上の関数の値
+        */
+        LogMeshSpline(std::vector<double> const & x, std::vector<double> const & y);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~LogMeshSpline() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            関数の値を補間で求める（原点側の外側では端の値、遠方の外側では0を返す）
+            \param r rの値
+            \return 関数の値
+        */
+        double operator()(double r) const;
+
+        //!  A public member function (const).
+        /*!
+            n個のrについて、関数の値（と、必要なら1階微分）をまとめて求める
+            対数の計算と、区間の添字の計算・多項式の評価を別々のループに分けて、ループがベクトル化されるようにする
+            \param n rの個数
+            \param r rの配列
+            \param f 関数の値の出力先
+            \param df 1階微分の出力先（nullptrなら求めない、メッシュの外側では0）
+        */
+        void Evaluate(std::size_t n, double const * r, double * f, double * df) const;
+
+        //!  A public member function (const).
+        /*!
+            x_i <= r < x_{i + 1}となる区間の添字iを返す
+            \param r rの値（メッシュの範囲内）
+            \return 区間の添字
+        */
+        std::size_t Index(double r) const;
+
+        //!  A public member function (const).
+        /*!
+            メッシュが対数メッシュと認識されたかどうかを返す
+            \return 対数メッシュならtrue
+        */
+        bool IsLogMesh() const
+        {
+            return logmesh_;
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member function (const).
+        /*!
+            rの対数（対数メッシュの場合）から、x_i <= r < x_{i + 1}となる区間の添字iを返す
+            \param r rの値（メッシュの範囲内）
+            \param logr rの対数（対数メッシュでない場合は使わない）
+            \return 区間の添字
+        */
+        std::size_t Index(double r, double logr) const;
+
+        //! A private static member variable (constant).
+        /*!
+            まとめて評価する時に、一度に対数を求めるrの個数
+        */
+        static std::size_t const BLOCK = 64;
+
+        //! A private static member variable (constant).
+        /*!
+            対数メッシュとみなす、隣り合う点の比の対数のずれの上限（相対値）
+        */
+        static double const LOGMESH_TOLERANCE;
+
+        //! A private member variable.
+        /*!
+            区間ごとの補間の係数（連続した領域に並べる）
+        */
+        std::vector<LogMeshSpline::coefficient_type> coef_;
+
+        //! A private member variable.
+        /*!
+            対数メッシュの刻み幅dxの逆数
+        */
+        double invdx_;
+
+        //! A private member variable.
+        /*!
+            メッシュが対数メッシュかどうか
+        */
+        bool logmesh_;
+
+        //! A private member variable.
+        /*!
+            メッシュの最初の点の対数
+        */
+        double logx0_;
+
+        //! A private member variable.
+        /*!
+            メッシュの点（フォールバックの二分探索用）
+        */
+        std::vector<double> x_;
+
+        //! A private member variable.
+        /*!
+            メッシュの最後の点での関数の値
+        */
+        double ylast_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        LogMeshSpline() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        LogMeshSpline(LogMeshSpline const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        LogMeshSpline & operator=(LogMeshSpline const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _LOGMESHSPLINE_H_
@@ -0,0 +1,50 @@
+﻿/*! \file myrandstreams.cpp
+    \brief スレッドごとの乱数ストリームを管理するクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "myrandstreams.h"
+#include <random>   // for std::random_device
+
+namespace myrandom {
+    // #region コンストラクタ
+
+    MyRandStreams::MyRandStreams() :
+        base_(0),
+        count_(0)
+    {
+        reseed();
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void MyRandStreams::reseed()
+    {
+        // ランダムデバイス
+        std::random_device rnd;
+
+        // 64ビットのシードを作る
+        auto const seed = (static_cast<std::uint64_t>(rnd()) << 32) | static_cast<std::uint64_t>(rnd());
+
+        base_ = Xoshiro256(seed);
+        count_.store(0);
+
+        // 各スレッドのエンジンは、大元のエンジンを払い出した順にjumpさせて作る
+        pets_.reset(new ets_type([this] {
+            auto engine(base_);
+            auto const n = count_.fetch_add(1);
+            for (auto i = 0ULL; i <= n; i++) {
+                engine.jump();
+            }
+
+            return engine;
+        }));
+    }
+
+    // #endregion メンバ関数
+}
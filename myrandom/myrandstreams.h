@@ -0,0 +1,113 @@
+﻿/*! \file myrandstreams.h
+    \brief スレッドごとの乱数ストリームを管理するクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _MYRANDSTREAMS_H_
+#define _MYRANDSTREAMS_H_
+
+#pragma once
+
+#include "xoshiro256.h"
+#include <atomic>                               // for std::atomic
+#include <cstdint>                              // for std::uint64_t
+#include <memory>                               // for std::unique_ptr
+#include <tbb/enumerable_thread_specific.h>     // for tbb::enumerable_thread_specific
+
+namespace myrandom {
+    //! A class.
+    /*!
+        TBBのワーカースレッドごとに独立した乱数ストリームを与えるクラス
+        std::random_deviceは再描画ごとに一度しか呼ばれない
+    */
+    class MyRandStreams final {
+        // #region 型エイリアス
+
+    public:
+        using ets_type = tbb::enumerable_thread_specific<Xoshiro256>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+        */
+        MyRandStreams();
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~MyRandStreams() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            呼び出したスレッドの乱数エンジンを返す
+            \return 呼び出したスレッドの乱数エンジン
+        */
+        Xoshiro256 & local()
+        {
+            return pets_->local();
+        }
+
+        //!  A public member function.
+        /*!
+            新しいシードですべてのストリームを作り直す
+            ストリームを使っているスレッドがない時に呼ぶこと
+        */
+        void reseed();
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            ストリームの大元になる乱数エンジン
+        */
+        Xoshiro256 base_;
+
+        //! A private member variable.
+        /*!
+            これまでに払い出したストリームの数
+        */
+        std::atomic<std::uint64_t> count_;
+
+        //! A private member variable.
+        /*!
+            スレッドごとの乱数エンジンへのスマートポインタ
+        */
+        std::unique_ptr<ets_type> pets_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        MyRandStreams(MyRandStreams const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        MyRandStreams & operator=(MyRandStreams const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _MYRANDSTREAMS_H_
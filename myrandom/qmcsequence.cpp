@@ -0,0 +1,117 @@
+﻿/*! \file qmcsequence.cpp
+    \brief スクランブルされた低食い違い量列（Sobol列、Halton列）クラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "qmcsequence.h"
+#include "xoshiro256.h"
+#include <utility>  // for std::swap
+
+namespace myrandom {
+    // #region コンストラクタ
+
+    QmcSequence::QmcSequence(QmcSequence::Sequence_type type, std::uint64_t seed) :
+        type_(type)
+    {
+        Xoshiro256 rs(seed);
+
+        // Halton列の底は最初の4つの素数
+        base_ = { { 2, 3, 5, 7 } };
+
+        // Sobol列の方向数（Joe and Kuoの原始多項式と初期値の、最初の4次元分）
+        // 1次元目はvan der Corput列
+        for (auto k = 0; k < SOBOLBITS; k++) {
+            v_[0][k] = 1U << (SOBOLBITS - 1 - k);
+        }
+
+        static std::int32_t const S[] = { 1, 2, 3 };
+        static std::uint32_t const A[] = { 0, 1, 1 };
+        static std::uint32_t const M[][3] = { { 1, 0, 0 }, { 1, 3, 0 }, { 1, 3, 1 } };
+
+        for (auto d = 1; d < DIMENSION; d++) {
+            auto const s = S[d - 1];
+            auto const a = A[d - 1];
+            for (auto k = 0; k < s; k++) {
+                v_[d][k] = M[d - 1][k] << (SOBOLBITS - 1 - k);
+            }
+
+            for (auto k = s; k < SOBOLBITS; k++) {
+                v_[d][k] = v_[d][k - s] ^ (v_[d][k - s] >> s);
+                for (auto i = 1; i < s; i++) {
+                    if ((a >> (s - 1 - i)) & 1U) {
+                        v_[d][k] ^= v_[d][k - i];
+                    }
+                }
+            }
+        }
+
+        // Sobol列はランダムなディジタルシフトでスクランブルする
+        for (auto & s : shift_) {
+            s = static_cast<std::uint32_t>(rs() >> 32);
+        }
+
+        // Halton列は倍精度の仮数部が尽きるまでの桁ごとに、数字のランダムな置換をかける
+        for (auto d = 0; d < DIMENSION; d++) {
+            auto const b = base_[d];
+            auto scale = 1.0;
+            while (scale > 1.0 / 9007199254740992.0) {
+                std::vector<std::uint32_t> p(b);
+                for (auto i = 0U; i < b; i++) {
+                    p[i] = i;
+                }
+
+                // Fisher-Yatesのシャッフル
+                for (auto i = b - 1; i > 0; i--) {
+                    std::swap(p[i], p[static_cast<std::uint32_t>(rs.myrand() * static_cast<double>(i + 1))]);
+                }
+
+                perm_[d].push_back(p);
+                scale /= static_cast<double>(b);
+            }
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void QmcSequence::Point(std::uint64_t index, double * first) const
+    {
+        for (auto d = 0; d < DIMENSION; d++) {
+            first[d] = type_ == QmcSequence::Sequence_type::SOBOL ? Sobol(index, d) : Halton(index, d);
+        }
+    }
+
+    double QmcSequence::Halton(std::uint64_t index, std::int32_t d) const
+    {
+        auto const b = base_[d];
+        auto const invb = 1.0 / static_cast<double>(b);
+
+        // 置換は上位の0の桁にもかけるので、桁数は固定にする
+        auto x = 0.0, scale = invb;
+        for (auto const & p : perm_[d]) {
+            x += static_cast<double>(p[index % b]) * scale;
+            index /= b;
+            scale *= invb;
+        }
+
+        return x < 1.0 ? x : 1.0 - 1.0 / 9007199254740992.0;
+    }
+
+    double QmcSequence::Sobol(std::uint64_t index, std::int32_t d) const
+    {
+        auto x = shift_[d];
+        for (auto k = 0; index && k < SOBOLBITS; k++, index >>= 1) {
+            if (index & 1ULL) {
+                x ^= v_[d][k];
+            }
+        }
+
+        return static_cast<double>(x) * (1.0 / 4294967296.0);
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,163 @@
+﻿/*! \file qmcsequence.h
+    \brief スクランブルされた低食い違い量列（Sobol列、Halton列）クラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _QMCSEQUENCE_H_
+#define _QMCSEQUENCE_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstdint>  // for std::int32_t, std::uint32_t, std::uint64_t
+#include <vector>   // for std::vector
+
+namespace myrandom {
+    //! A class.
+    /*!
+        [0, 1)^DIMENSIONの低食い違い量列を、添字から直接計算するクラス
+        添字だけで点が決まるので、スレッドごとに重ならない添字の範囲を割り当てれば並列に使える
+    */
+    class QmcSequence final {
+        // #region 列挙型
+
+    public:
+        //!  A enumerated type
+        /*!
+            低食い違い量列の種類を表す列挙型
+        */
+        enum class Sequence_type {
+            // ランダムなディジタルシフトをかけたSobol列
+            SOBOL,
+            // 桁ごとにランダムな置換をかけたHalton列
+            HALTON
+        };
+
+        // #endregion 列挙型
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param type 低食い違い量列の種類
+            \param seed スクランブルに使う乱数のシード
+        */
+        QmcSequence(QmcSequence::Sequence_type type, std::uint64_t seed);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~QmcSequence() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            添字indexの点を求める
+            \param index 点の添字
+            \param first 出力先の先頭（DIMENSION個の要素を書き込む）
+        */
+        void Point(std::uint64_t index, double * first) const;
+
+    private:
+        //!  A private member function (const).
+        /*!
+            Halton列のd次元目の座標を求める
+            \param index 点の添字
+            \param d 次元
+            \return 座標
+        */
+        double Halton(std::uint64_t index, std::int32_t d) const;
+
+        //!  A private member function (const).
+        /*!
+            Sobol列のd次元目の座標を求める
+            \param index 点の添字
+            \param d 次元
+            \return 座標
+        */
+        double Sobol(std::uint64_t index, std::int32_t d) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    public:
+        //! A public static member variable (constant).
+        /*!
+            点の次元
+        */
+        static std::int32_t const DIMENSION = 4;
+
+    private:
+        //! A private static member variable (constant).
+        /*!
+            Sobol列の方向数のビット数
+        */
+        static std::int32_t const SOBOLBITS = 32;
+
+        //! A private member variable.
+        /*!
+            Halton列の次元ごとの底
+        */
+        std::array<std::uint32_t, DIMENSION> base_;
+
+        //! A private member variable.
+        /*!
+            Halton列の次元ごと、桁ごとの数字の置換
+        */
+        std::array<std::vector<std::vector<std::uint32_t>>, DIMENSION> perm_;
+
+        //! A private member variable.
+        /*!
+            Sobol列の次元ごとのディジタルシフト
+        */
+        std::array<std::uint32_t, DIMENSION> shift_;
+
+        //! A private member variable.
+        /*!
+            低食い違い量列の種類
+        */
+        QmcSequence::Sequence_type type_;
+
+        //! A private member variable.
+        /*!
+            Sobol列の次元ごとの方向数
+        */
+        std::array<std::array<std::uint32_t, SOBOLBITS>, DIMENSION> v_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        QmcSequence() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        QmcSequence(QmcSequence const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        QmcSequence & operator=(QmcSequence const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _QMCSEQUENCE_H_
@@ -0,0 +1,41 @@
+﻿/*! \file qmcstreams.cpp
+    \brief スレッドごとに重ならない添字の範囲で低食い違い量列を払い出すクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "qmcstreams.h"
+#include <random>   // for std::random_device
+
+namespace myrandom {
+    // #region コンストラクタ
+
+    QmcStreams::QmcStreams() :
+        next_(0)
+    {
+        reset(QmcSequence::Sequence_type::SOBOL);
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void QmcStreams::reset(QmcSequence::Sequence_type type)
+    {
+        // ランダムデバイス
+        std::random_device rnd;
+
+        // スクランブル用の64ビットのシードを作る
+        auto const seed = (static_cast<std::uint64_t>(rnd()) << 32) | static_cast<std::uint64_t>(rnd());
+
+        pseq_.reset(new QmcSequence(type, seed));
+        next_.store(0);
+
+        // 各スレッドは空の範囲から始め、最初の呼び出しでブロックを受け取る
+        pets_.reset(new ets_type(std::make_pair(0ULL, 0ULL)));
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,127 @@
+﻿/*! \file qmcstreams.h
+    \brief スレッドごとに重ならない添字の範囲で低食い違い量列を払い出すクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _QMCSTREAMS_H_
+#define _QMCSTREAMS_H_
+
+#pragma once
+
+#include "qmcsequence.h"
+#include <atomic>                               // for std::atomic
+#include <cstdint>                              // for std::uint64_t
+#include <memory>                               // for std::unique_ptr
+#include <utility>                              // for std::pair
+#include <tbb/enumerable_thread_specific.h>     // for tbb::enumerable_thread_specific
+
+namespace myrandom {
+    //! A class.
+    /*!
+        低食い違い量列の添字をCHUNK個ずつのブロックに分け、TBBのワーカースレッドに払い出すクラス
+        払い出したブロックの和は列の先頭からの連続した範囲になるので、全体として低食い違い性が保たれる
+    */
+    class QmcStreams final {
+        // #region 型エイリアス
+
+    public:
+        using ets_type = tbb::enumerable_thread_specific<std::pair<std::uint64_t, std::uint64_t>>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+        */
+        QmcStreams();
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~QmcStreams() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            呼び出したスレッドの次の点を求める
+            \param first 出力先の先頭（QmcSequence::DIMENSION個の要素を書き込む）
+        */
+        void next(double * first)
+        {
+            auto & range = pets_->local();
+            if (range.first == range.second) {
+                range.first = next_.fetch_add(CHUNK);
+                range.second = range.first + CHUNK;
+            }
+
+            pseq_->Point(range.first++, first);
+        }
+
+        //!  A public member function.
+        /*!
+            新しいスクランブルで列を作り直し、添字を先頭に戻す
+            ストリームを使っているスレッドがない時に呼ぶこと
+            \param type 低食い違い量列の種類
+        */
+        void reset(QmcSequence::Sequence_type type);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant).
+        /*!
+            一度に払い出す添字の数
+        */
+        static std::uint64_t const CHUNK = 1024;
+
+    private:
+        //! A private member variable.
+        /*!
+            次に払い出す添字
+        */
+        std::atomic<std::uint64_t> next_;
+
+        //! A private member variable.
+        /*!
+            スレッドごとの払い出された添字の範囲へのスマートポインタ
+        */
+        std::unique_ptr<ets_type> pets_;
+
+        //! A private member variable.
+        /*!
+            低食い違い量列へのスマートポインタ
+        */
+        std::unique_ptr<QmcSequence> pseq_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        QmcStreams(QmcStreams const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        QmcStreams & operator=(QmcStreams const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _QMCSTREAMS_H_
@@ -0,0 +1,187 @@
+﻿/*! \file xoshiro256.h
+    \brief 高速な乱数エンジン（xoshiro256**）クラスの宣言と実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    (but this is originally adapted by David Blackman and Sebastiano Vigna for xoshiro256** from http://xoshiro.di.unimi.it/ )
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _XOSHIRO256_H_
+#define _XOSHIRO256_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+
+namespace myrandom {
+    //! A class.
+    /*!
+        状態が256ビットしかない高速な乱数エンジン
+        std::mt19937と違い、シードの設定とストリームの分割がほぼ無償で行える
+    */
+    class Xoshiro256 final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param seed 乱数のシード（splitmix64で256ビットの状態に展開される）
+        */
+        explicit Xoshiro256(std::uint64_t seed)
+        {
+            for (auto & s : s_) {
+                s = splitmix64(seed);
+            }
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Xoshiro256() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            64ビットの乱数を生成する
+            \return 64ビットの乱数
+        */
+        std::uint64_t operator()()
+        {
+            auto const result = rotl(s_[1] * 5, 7) * 9;
+            auto const t = s_[1] << 17;
+
+            s_[2] ^= s_[0];
+            s_[3] ^= s_[1];
+            s_[1] ^= s_[2];
+            s_[0] ^= s_[3];
+
+            s_[2] ^= t;
+            s_[3] = rotl(s_[3], 45);
+
+            return result;
+        }
+
+        //!  A public member function.
+        /*!
+            複数の一様乱数をまとめて生成する
+            \param first 出力先の先頭
+            \param n 生成する乱数の個数
+            \param min 乱数分布の最小値
+            \param max 乱数分布の最大値
+        */
+        void fill(double * first, std::size_t n, double min, double max)
+        {
+            auto const width = max - min;
+            for (auto i = 0U; i < n; i++) {
+                first[i] = min + width * myrand();
+            }
+        }
+
+        //!  A public member function.
+        /*!
+            2^128回分だけ状態を進める
+            同じシードから作ったエンジンをjumpすることで、重ならないストリームが得られる
+        */
+        void jump()
+        {
+            static std::array<std::uint64_t, 4> const JUMP = {
+                0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+            };
+
+            std::array<std::uint64_t, 4> s = { 0, 0, 0, 0 };
+            for (auto const j : JUMP) {
+                for (auto b = 0; b < 64; b++) {
+                    if (j & (1ULL << b)) {
+                        for (auto i = 0; i < 4; i++) {
+                            s[i] ^= s_[i];
+                        }
+                    }
+                    (*this)();
+                }
+            }
+
+            s_ = s;
+        }
+
+        //!  A public member function.
+        /*!
+            [0.0, 1.0)の半開区間で一様乱数を生成する
+            \return 一様乱数
+        */
+        double myrand()
+        {
+            // 上位53ビットを仮数部に使う
+            return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        //!  A public member function.
+        /*!
+            [min, max)の半開区間で一様乱数を生成する
+            \param min 乱数分布の最小値
+            \param max 乱数分布の最大値
+            \return 一様乱数
+        */
+        double myrand(double min, double max)
+        {
+            return min + (max - min) * myrand();
+        }
+
+    private:
+        //!  A private static member function.
+        /*!
+            ビットを左に回転する
+            \param x 回転させる値
+            \param k 回転させるビット数
+            \return 回転させた値
+        */
+        static std::uint64_t rotl(std::uint64_t x, std::int32_t k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        //!  A private static member function.
+        /*!
+            splitmix64で64ビットのシードを攪拌する
+            \param x シード（呼び出しごとに更新される）
+            \return 攪拌された値
+        */
+        static std::uint64_t splitmix64(std::uint64_t & x)
+        {
+            auto z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            乱数エンジンの状態
+        */
+        std::array<std::uint64_t, 4> s_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Xoshiro256() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _XOSHIRO256_H_
@@ -0,0 +1,65 @@
+﻿/*! \file aliastable.cpp
+    \brief Walkerのエイリアス法で離散分布をサンプリングするクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "aliastable.h"
+#include <numeric>              // for std::accumulate
+#include <stdexcept>            // for std::invalid_argument
+#include <boost/assert.hpp>     // for BOOST_ASSERT
+
+namespace sampler {
+    // #region コンストラクタ
+
+    AliasTable::AliasTable(std::vector<double> const & weights) :
+        alias_(weights.size()),
+        prob_(weights.size())
+    {
+        auto const n = weights.size();
+        auto const total = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (!n || total <= 0.0) {
+            throw std::invalid_argument("重みの総和が0です！");
+        }
+
+        // Voseの方法：平均より小さいものと大きいものに分けて、対にしていく
+        std::vector<double> scaled(n);
+        std::vector<std::size_t> small, large;
+        for (auto i = 0U; i < n; i++) {
+            scaled[i] = weights[i] * static_cast<double>(n) / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            auto const s = small.back();
+            small.pop_back();
+            auto const l = large.back();
+
+            prob_[s] = scaled[s];
+            alias_[s] = l;
+
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // 丸め誤差で残ったものは確率1にする
+        for (auto const i : large) {
+            prob_[i] = 1.0;
+            alias_[i] = i;
+        }
+
+        for (auto const i : small) {
+            prob_[i] = 1.0;
+            alias_[i] = i;
+        }
+
+        BOOST_ASSERT(alias_.size() == n);
+    }
+
+    // #endregion コンストラクタ
+}
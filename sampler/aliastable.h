@@ -0,0 +1,111 @@
+﻿/*! \file aliastable.h
+    \brief Walkerのエイリアス法で離散分布をサンプリングするクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ALIASTABLE_H_
+#define _ALIASTABLE_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        Walkerのエイリアス法で、重みに比例した確率で添字をO(1)で選ぶクラス
+    */
+    class AliasTable final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param weights 各添字の重み（非負で、総和が正であること）
+        */
+        explicit AliasTable(std::vector<double> const & weights);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AliasTable() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            重みに比例した確率で添字を一つ選ぶ
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 選ばれた添字
+        */
+        std::size_t operator()(myrandom::Xoshiro256 & rs) const
+        {
+            auto const u = rs.myrand() * static_cast<double>(prob_.size());
+            auto const i = static_cast<std::size_t>(u);
+            return u - static_cast<double>(i) < prob_[i] ? i : alias_[i];
+        }
+
+        //!  A public member function (const).
+        /*!
+            添字の数を返す
+            \return 添字の数
+        */
+        std::size_t size() const
+        {
+            return prob_.size();
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            エイリアスの表
+        */
+        std::vector<std::size_t> alias_;
+
+        //! A private member variable.
+        /*!
+            自分自身が選ばれる確率の表
+        */
+        std::vector<double> prob_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AliasTable() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        AliasTable(AliasTable const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AliasTable & operator=(AliasTable const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _ALIASTABLE_H_
@@ -0,0 +1,109 @@
+﻿/*! \file angularsampler.cpp
+    \brief 球面調和関数の角度分布から(θ, φ)を直接サンプリングするクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "angularsampler.h"
+#include <algorithm>                                    // for std::upper_bound
+#include <cmath>                                        // for std::asin, std::cos, std::fabs, std::sqrt
+#include <cstdlib>                                      // for std::abs
+#include <boost/math/constants/constants.hpp>           // for boost::math::constants::pi
+#include <boost/math/special_functions/legendre.hpp>    // for boost::math::legendre_p
+
+namespace sampler {
+    // #region コンストラクタ
+
+    AngularSampler::AngularSampler(std::uint32_t l, std::int32_t m, bool sine, bool squared) :
+        cdf_(TABLESIZE + 1, 0.0),
+        m_(std::abs(m)),
+        sine_(sine),
+        squared_(squared)
+    {
+        // cosθについての重みP_l^|m|(x)^2（または|P_l^|m|(x)|）を台形公式で積分する
+        auto weight = [this, l](double x) {
+            auto const p = boost::math::legendre_p(static_cast<int>(l), m_, x);
+            return squared_ ? p * p : std::fabs(p);
+        };
+
+        auto const dx = 2.0 / static_cast<double>(TABLESIZE);
+        auto w0 = weight(-1.0);
+        for (auto i = 1U; i <= TABLESIZE; i++) {
+            auto const w1 = weight(-1.0 + dx * static_cast<double>(i));
+            cdf_[i] = cdf_[i - 1] + 0.5 * (w0 + w1) * dx;
+            w0 = w1;
+        }
+
+        auto const total = cdf_.back();
+        for (auto & v : cdf_) {
+            v /= total;
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void AngularSampler::operator()(myrandom::Xoshiro256 & rs, double & costheta, double & phi) const
+    {
+        costheta = samplecostheta(rs);
+        phi = samplephi(rs);
+    }
+
+    double AngularSampler::samplecostheta(myrandom::Xoshiro256 & rs) const
+    {
+        auto const u = rs.myrand();
+
+        // cdf_[i - 1] <= u < cdf_[i]となるiを二分探索で求め、区間内は線形補間する
+        auto const i = static_cast<std::size_t>(std::upper_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin());
+        if (i >= cdf_.size()) {
+            return 1.0;
+        }
+
+        auto const du = cdf_[i] - cdf_[i - 1];
+        auto const t = du > 0.0 ? (u - cdf_[i - 1]) / du : 0.0;
+        auto const dx = 2.0 / static_cast<double>(TABLESIZE);
+
+        return -1.0 + dx * (static_cast<double>(i - 1) + t);
+    }
+
+    double AngularSampler::samplephi(myrandom::Xoshiro256 & rs) const
+    {
+        auto const pi = boost::math::constants::pi<double>();
+
+        if (!m_) {
+            return rs.myrand(0.0, 2.0 * pi);
+        }
+
+        // |m|φ = kπ + αと分解すると、αは[-π/2, π/2]でcos^2α（またはcosα）に従う
+        // sinα = vと変数変換すると、vは半円分布（または一様分布）に従うので解析的に生成できる
+        double v;
+        if (squared_) {
+            // 単位円内の一様な点のx座標は半円分布に従う
+            v = std::sqrt(rs.myrand()) * std::cos(rs.myrand(0.0, 2.0 * pi));
+        }
+        else {
+            v = rs.myrand(-1.0, 1.0);
+        }
+
+        auto const alpha = std::asin(v);
+
+        // 2|m|個あるローブのうちどれかを等確率で選ぶ
+        auto const k = static_cast<std::int32_t>(rs.myrand() * static_cast<double>(2 * m_));
+
+        // sin(|m|φ) = cos(|m|φ - π/2)なので、sinの場合はローブの中心をπ/2だけずらす
+        auto phi = (static_cast<double>(k) * pi + alpha + (sine_ ? 0.5 * pi : 0.0)) / static_cast<double>(m_);
+        if (phi < 0.0) {
+            phi += 2.0 * pi;
+        }
+        else if (phi >= 2.0 * pi) {
+            phi -= 2.0 * pi;
+        }
+
+        return phi;
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,135 @@
+﻿/*! \file angularsampler.h
+    \brief 球面調和関数の角度分布から(θ, φ)を直接サンプリングするクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ANGULARSAMPLER_H_
+#define _ANGULARSAMPLER_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cstdint>  // for std::int32_t, std::uint32_t
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        実数の球面調和関数 N P_l^|m|(cosθ) cos(|m|φ)（またはsin(|m|φ)）の
+        2乗（電子密度）または絶対値（波動関数）に従う(θ, φ)を、棄却なしでサンプリングするクラス
+    */
+    class AngularSampler final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param l 方位量子数
+            \param m 磁気量子数（符号は無視される）
+            \param sine φ部分がsin(|m|φ)ならtrue、cos(|m|φ)ならfalse
+            \param squared 2乗の分布ならtrue、絶対値の分布ならfalse
+        */
+        AngularSampler(std::uint32_t l, std::int32_t m, bool sine, bool squared);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AngularSampler() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            角度分布に従う(cosθ, φ)を一組生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param costheta 生成されたcosθ
+            \param phi 生成されたφ（[0, 2π)）
+        */
+        void operator()(myrandom::Xoshiro256 & rs, double & costheta, double & phi) const;
+
+    private:
+        //!  A private member function (const).
+        /*!
+            cos(|m|φ)^2（または|cos(|m|φ)|）に従うφを解析的に生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 生成されたφ
+        */
+        double samplephi(myrandom::Xoshiro256 & rs) const;
+
+        //!  A private member function (const).
+        /*!
+            P_l^|m|(cosθ)^2（または|P_l^|m|(cosθ)|）に従うcosθを、累積分布関数の表から生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 生成されたcosθ
+        */
+        double samplecostheta(myrandom::Xoshiro256 & rs) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            cosθの表の分割数
+        */
+        static std::vector<double>::size_type const TABLESIZE = 4096;
+
+        //! A private member variable.
+        /*!
+            cosθの累積分布関数の表（cosθ = -1から1まで等間隔）
+        */
+        std::vector<double> cdf_;
+
+        //! A private member variable.
+        /*!
+            磁気量子数の絶対値
+        */
+        std::int32_t m_;
+
+        //! A private member variable.
+        /*!
+            φ部分がsin(|m|φ)かどうか
+        */
+        bool sine_;
+
+        //! A private member variable.
+        /*!
+            2乗の分布かどうか
+        */
+        bool squared_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AngularSampler() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        AngularSampler(AngularSampler const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AngularSampler & operator=(AngularSampler const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _ANGULARSAMPLER_H_
@@ -0,0 +1,149 @@
+﻿/*! \file angulartable.cpp
+    \brief 角度部分の値を(θ, φ)の格子上の表から補間で求めるクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "angulartable.h"
+#include <algorithm>                            // for std::max, std::min
+#include <cmath>                                // for std::acos, std::cos, std::fabs, std::floor
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+#include <tbb/parallel_for.h>                   // for tbb::parallel_for
+
+namespace sampler {
+    namespace {
+        //! A function.
+        /*!
+            Catmull-Romの3次補間
+            \param p0 一つ前の点の値
+            \param p1 区間の始点の値
+            \param p2 区間の終点の値
+            \param p3 一つ後の点の値
+            \param t 区間内の位置（[0, 1]）
+            \return 補間された値
+        */
+        double CatmullRom(double p0, double p1, double p2, double p3, double t)
+        {
+            return p1 + 0.5 * t * (p2 - p0 + t * (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3 + t * (3.0 * (p1 - p2) + p3 - p0)));
+        }
+    }
+
+    // #region コンストラクタ
+
+    AngularTable::AngularTable(function_type const & func, std::int32_t n, AngularTable::Interpolation_type interpolation) :
+        absmax_(0.0),
+        interpolation_(interpolation),
+        maxerror_(0.0),
+        n_(n),
+        nphi_(2 * n),
+        value_(static_cast<std::size_t>(n + 1) * (2 * n))
+    {
+        auto const dtheta = boost::math::constants::pi<double>() / static_cast<double>(n_);
+        auto const dphi = 2.0 * boost::math::constants::pi<double>() / static_cast<double>(nphi_);
+
+        // 格子点での値（θ方向の行ごとに並列化）
+        tbb::parallel_for(
+            0,
+            n_ + 1,
+            [&](std::int32_t i) {
+                auto const costheta = std::cos(dtheta * static_cast<double>(i));
+                for (auto j = 0; j < nphi_; j++) {
+                    value_[static_cast<std::size_t>(i) * nphi_ + j] = func(costheta, dphi * static_cast<double>(j));
+                }
+            });
+
+        for (auto const v : value_) {
+            absmax_ = std::max(absmax_, std::fabs(v));
+        }
+
+        // 各区画の中点と、二つの辺の中点で補間の誤差を調べる
+        std::vector<double> rowerror(n_);
+        tbb::parallel_for(
+            0,
+            n_,
+            [&](std::int32_t i) {
+                auto err = 0.0;
+                for (auto j = 0; j < nphi_; j++) {
+                    auto const t0 = dtheta * static_cast<double>(i);
+                    auto const p0 = dphi * static_cast<double>(j);
+                    double const probe[][2] = {
+                        { std::cos(t0 + 0.5 * dtheta), p0 + 0.5 * dphi },
+                        { std::cos(t0 + 0.5 * dtheta), p0 },
+                        { std::cos(t0), p0 + 0.5 * dphi }
+                    };
+
+                    for (auto const & p : probe) {
+                        err = std::max(err, std::fabs((*this)(p[0], p[1]) - func(p[0], p[1])));
+                    }
+                }
+
+                rowerror[i] = err;
+            });
+
+        for (auto const e : rowerror) {
+            maxerror_ = std::max(maxerror_, e);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    double AngularTable::operator()(double costheta, double phi) const
+    {
+        // θ方向の位置（cosθの格子にすると、|m|が奇数の時にsinθの因子が極で微分できず、補間の誤差が大きくなる）
+        auto const theta = std::acos(std::min(std::max(costheta, -1.0), 1.0));
+        auto const u = theta * (static_cast<double>(n_) / boost::math::constants::pi<double>());
+        auto const i = std::min(static_cast<std::int32_t>(u), n_ - 1);
+        auto const s = u - static_cast<double>(i);
+
+        // φ方向の位置（周期的）
+        auto v = phi * (static_cast<double>(nphi_) / (2.0 * boost::math::constants::pi<double>()));
+        v -= std::floor(v / static_cast<double>(nphi_)) * static_cast<double>(nphi_);
+        auto const j = std::min(static_cast<std::int32_t>(v), nphi_ - 1);
+        auto const t = v - static_cast<double>(j);
+
+        switch (interpolation_) {
+        case AngularTable::Interpolation_type::BILINEAR:
+        {
+            auto const v0 = At(i, j) + t * (At(i, j + 1) - At(i, j));
+            auto const v1 = At(i + 1, j) + t * (At(i + 1, j + 1) - At(i + 1, j));
+            return v0 + s * (v1 - v0);
+        }
+
+        case AngularTable::Interpolation_type::BICUBIC:
+        {
+            double row[4];
+            for (auto k = 0; k < 4; k++) {
+                auto const ii = i - 1 + k;
+                row[k] = CatmullRom(At(ii, j - 1), At(ii, j), At(ii, j + 1), At(ii, j + 2), t);
+            }
+
+            return CatmullRom(row[0], row[1], row[2], row[3], s);
+        }
+
+        default:
+            return 0.0;
+        }
+    }
+
+    double AngularTable::At(std::int32_t i, std::int32_t j) const
+    {
+        // 極を越えた点は、反対側の経線（φ + π）の点と同じ
+        if (i < 0) {
+            i = -i;
+            j += nphi_ / 2;
+        }
+        else if (i > n_) {
+            i = 2 * n_ - i;
+            j += nphi_ / 2;
+        }
+
+        j = (j % nphi_ + nphi_) % nphi_;
+        return value_[static_cast<std::size_t>(i) * nphi_ + j];
+    }
+
+    // #endregion メンバ関数
+}
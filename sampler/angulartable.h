@@ -0,0 +1,186 @@
+﻿/*! \file angulartable.h
+    \brief 角度部分の値を(θ, φ)の格子上の表から補間で求めるクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ANGULARTABLE_H_
+#define _ANGULARTABLE_H_
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t
+#include <functional>   // for std::function
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        角度部分の関数を、θ ∈ [0, π]（n + 1点）とφ ∈ [0, 2π)（2n点、周期的）の格子で表にするクラス
+        対話的なプレビューのために、小さな誤差と引き換えに評価を速くする
+        構築時に、格子の間での補間の最大誤差を実際の関数と比べて求めておく
+    */
+    class AngularTable final {
+        // #region 列挙型
+
+    public:
+        //!  A enumerated type
+        /*!
+            補間の方法を表す列挙型
+        */
+        enum class Interpolation_type {
+            // 双線形補間
+            BILINEAR,
+            // 双三次補間（Catmull-Rom）
+            BICUBIC
+        };
+
+        // #endregion 列挙型
+
+        // #region 型エイリアス
+
+        using function_type = std::function<double(double, double)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（格子点での評価と誤差の見積もりはTBBで並列に行う）
+            \param func 表にする関数（引数はcosθとφ）
+            \param n θ方向の区間の数（φ方向は2n区間）
+            \param interpolation 補間の方法
+        */
+        AngularTable(function_type const & func, std::int32_t n, AngularTable::Interpolation_type interpolation);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~AngularTable() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            (cosθ, φ)での値を補間で求める
+            \param costheta cosθ
+            \param phi φ（[0, 2π)の外でもよい）
+            \return 補間された値
+        */
+        double operator()(double costheta, double phi) const;
+
+        //!  A public member function (const).
+        /*!
+            表の使うメモリの量を返す
+            \return 表の使うメモリの量（バイト）
+        */
+        std::size_t Bytes() const
+        {
+            return value_.size() * sizeof(double);
+        }
+
+        //!  A public member function (const).
+        /*!
+            格子点での関数の絶対値の最大値を返す
+            \return 格子点での関数の絶対値の最大値
+        */
+        double AbsMax() const
+        {
+            return absmax_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            補間の最大誤差（格子の各区画の中点と辺の中点で、実際の関数と比べたもの）を返す
+            \return 補間の最大誤差
+        */
+        double MaxError() const
+        {
+            return maxerror_;
+        }
+
+    private:
+        //!  A private member function (const).
+        /*!
+            格子点の値を返す（θ方向は極で反対側の経線に折り返し、φ方向は周期的に折り返す）
+            \param i θ方向の添字
+            \param j φ方向の添字
+            \return 格子点の値
+        */
+        double At(std::int32_t i, std::int32_t j) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            格子点での関数の絶対値の最大値
+        */
+        double absmax_;
+
+        //! A private member variable.
+        /*!
+            補間の方法
+        */
+        AngularTable::Interpolation_type interpolation_;
+
+        //! A private member variable.
+        /*!
+            補間の最大誤差
+        */
+        double maxerror_;
+
+        //! A private member variable.
+        /*!
+            θ方向の区間の数
+        */
+        std::int32_t n_;
+
+        //! A private member variable.
+        /*!
+            φ方向の区間の数
+        */
+        std::int32_t nphi_;
+
+        //! A private member variable.
+        /*!
+            格子点の値（[i * nphi_ + j]にθ = πi / n、φ = 2πj / nphiの値が入る）
+        */
+        std::vector<double> value_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        AngularTable() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        AngularTable(AngularTable const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        AngularTable & operator=(AngularTable const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _ANGULARTABLE_H_
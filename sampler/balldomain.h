@@ -0,0 +1,139 @@
+﻿/*! \file balldomain.h
+    \brief 候補の点を球の内部に一様に生成するクラスの宣言と実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BALLDOMAIN_H_
+#define _BALLDOMAIN_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cmath>    // for std::sqrt
+#include <cstddef>  // for std::size_t
+
+namespace sampler {
+    //! A class.
+    /*!
+        棄却法の候補の点を、半径rmaxの球の内部に一様に生成するクラス
+        立方体の候補では、体積の48%が球の外側になり、角ではr = √3 rmaxまでデータのメッシュの外側を評価してしまう
+        球の外側の点は、目的の分布を評価する前に乱数3個だけで捨てる（三角関数も立方根も使わない）
+    */
+    class BallDomain final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param radius 球の半径
+        */
+        explicit BallDomain(double radius) : radius_(radius)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BallDomain() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            球の内部に一様に点を一つ生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param x 点のx座標
+            \param y 点のy座標
+            \param z 点のz座標
+            \return 点の原点からの距離
+        */
+        double operator()(myrandom::Xoshiro256 & rs, double & x, double & y, double & z) const
+        {
+            auto const r2max = radius_ * radius_;
+            auto r2 = 0.0;
+
+            do {
+                x = rs.myrand(-radius_, radius_);
+                y = rs.myrand(-radius_, radius_);
+                z = rs.myrand(-radius_, radius_);
+                r2 = x * x + y * y + z * z;
+            } while (r2 > r2max);
+
+            return std::sqrt(r2);
+        }
+
+        //!  A public member function (const).
+        /*!
+            球の内部に一様にn個の点を生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param n 点の数
+            \param x 点のx座標の出力先
+            \param y 点のy座標の出力先
+            \param z 点のz座標の出力先
+        */
+        void fill(myrandom::Xoshiro256 & rs, std::size_t n, double * x, double * y, double * z) const
+        {
+            // 立方体の候補をCHUNK個ずつまとめて生成し、球の内側の点を分岐なしで詰める
+            double c[3 * CHUNK];
+            auto const r2max = radius_ * radius_;
+
+            for (std::size_t count = 0; count < n;) {
+                rs.fill(c, 3 * CHUNK, -radius_, radius_);
+                for (auto k = 0U; k < CHUNK && count < n; k++) {
+                    auto const cx = c[k], cy = c[CHUNK + k], cz = c[2 * CHUNK + k];
+                    x[count] = cx;
+                    y[count] = cy;
+                    z[count] = cz;
+                    count += cx * cx + cy * cy + cz * cz <= r2max;
+                }
+            }
+        }
+
+        //!  A public member function (const).
+        /*!
+            球の半径を返す
+            \return 球の半径
+        */
+        double Radius() const
+        {
+            return radius_;
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private static member variable (constant).
+        /*!
+            まとめて生成する立方体の候補の数
+        */
+        static std::size_t const CHUNK = 16;
+
+        //! A private member variable.
+        /*!
+            球の半径
+        */
+        double radius_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        BallDomain() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _BALLDOMAIN_H_
@@ -0,0 +1,255 @@
+﻿/*! \file batchrejection.cpp
+    \brief 候補をまとめて評価する、SIMD化された棄却法のカーネルクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "batchrejection.h"
+#include <algorithm>                                            // for std::max, std::min
+#include <cmath>                                                // for std::fabs, std::sqrt
+#include <cstdlib>                                              // for std::abs
+#include <boost/math/constants/constants.hpp>                   // for boost::math::constants::pi
+#include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic_r, boost::math::spherical_harmonic_i
+
+// MSVCはアーキテクチャの指定に関係なくAVX2の組み込み関数を使えるので、実行時にCPUを調べて切り替える
+#if defined(_MSC_VER) || defined(__AVX2__)
+    #define SAMPLER_AVX2_KERNEL
+    #include <immintrin.h>                                      // for AVX2 intrinsics
+    #ifdef _MSC_VER
+        #include <intrin.h>                                     // for __cpuid, __cpuidex
+    #endif
+#endif
+
+namespace sampler {
+    // #region コンストラクタ
+
+    BatchRejection::BatchRejection(getdata::GetData const & gd, std::int32_t m, bool sine, double radius, double envelope) :
+        a_(gd.L() + 1),
+        absm_(static_cast<std::uint32_t>(std::abs(m))),
+        avx2_(HasAvx2()),
+        b_(gd.L() + 1),
+        ball_(radius),
+        c_(0.0),
+        envelope_(envelope),
+        l_(gd.L()),
+        radial_(NRADIAL + 2, 0.0),
+        rho_(gd.Rho_wf_type_ == getdata::GetData::Rho_Wf_type::RHO),
+        rmin_(gd.R_meshmin()),
+        sine_(sine),
+        zero_(sine && !m)
+    {
+        // 動径部分の表は、球の半径までを覆う（メッシュの外側はGetDataが0を返す）
+        auto const dr = radius / static_cast<double>(NRADIAL);
+        invdr_ = 1.0 / dr;
+        std::vector<double> r(NRADIAL + 1);
+        for (auto i = 0U; i <= NRADIAL; i++) {
+            r[i] = std::max(dr * static_cast<double>(i), rmin_);
+        }
+
+        gd(r.size(), r.data(), radial_.data());
+
+        // Legendre陪関数をsin^|m|θで割った多項式の漸化式の係数
+        for (auto l = absm_ + 1; l <= l_; l++) {
+            a_[l] = static_cast<double>(2 * l - 1) / static_cast<double>(l - absm_);
+            b_[l] = static_cast<double>(l + absm_ - 1) / static_cast<double>(l - absm_);
+        }
+
+        if (zero_) {
+            return;
+        }
+
+        // 形の絶対値が最大になるθで、Boostの球面調和関数と比べて定数（符号も含む）を決める
+        static auto const NTHETA = 256;
+        auto const phi = sine ? boost::math::constants::pi<double>() / static_cast<double>(2 * absm_) : 0.0;
+        auto best = 0.0, theta0 = 0.0;
+        for (auto i = 1; i < NTHETA; i++) {
+            auto const theta = boost::math::constants::pi<double>() * static_cast<double>(i) / static_cast<double>(NTHETA);
+            auto const shape = Angular(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+            if (std::fabs(shape) > std::fabs(best)) {
+                best = shape;
+                theta0 = theta;
+            }
+        }
+
+        auto const ylm = sine ?
+            boost::math::spherical_harmonic_i(l_, m, theta0, phi) :
+            boost::math::spherical_harmonic_r(l_, m, theta0, phi);
+        c_ = ylm / best;
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    std::size_t BatchRejection::operator()(myrandom::Xoshiro256 & rs, double * x, double * y, double * z, std::int32_t * sign) const
+    {
+        double cx[BATCH], cy[BATCH], cz[BATCH], u[BATCH], val[BATCH];
+        ball_.fill(rs, BATCH, cx, cy, cz);
+
+        // 波動関数が恒等的に0の場合は、候補をすべてそのまま採用する
+        if (zero_) {
+            for (auto i = 0U; i < BATCH; i++) {
+                x[i] = cx[i];
+                y[i] = cy[i];
+                z[i] = cz[i];
+                sign[i] = 0;
+            }
+
+            return BATCH;
+        }
+
+        rs.fill(u, BATCH, 0.0, envelope_);
+        auto mask = avx2_ ? AcceptAvx2(cx, cy, cz, u, val) : AcceptPortable(cx, cy, cz, u, val);
+
+        // 採択された候補だけを先頭から詰める
+        auto n = 0U;
+        for (auto i = 0U; mask; i++, mask >>= 1) {
+            if (mask & 1U) {
+                x[n] = cx[i];
+                y[n] = cy[i];
+                z[n] = cz[i];
+                sign[n] = rho_ ? 1 : (val[i] > 0.0) - (val[i] < 0.0);
+                n++;
+            }
+        }
+
+        return n;
+    }
+
+    std::uint32_t BatchRejection::AcceptAvx2(double const * x, double const * y, double const * z, double const * u, double * val) const
+    {
+#ifdef SAMPLER_AVX2_KERNEL
+        auto const vrmin = _mm256_set1_pd(rmin_);
+        auto const vinvdr = _mm256_set1_pd(invdr_);
+        auto const vc = _mm256_set1_pd(c_);
+        auto const vone = _mm256_set1_pd(1.0);
+        auto const vabs = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+
+        auto mask = 0U;
+        for (auto j = 0U; j < BATCH; j += 4) {
+            auto const vx = _mm256_loadu_pd(x + j);
+            auto const vy = _mm256_loadu_pd(y + j);
+            auto const vz = _mm256_loadu_pd(z + j);
+
+            auto const r = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)), _mm256_mul_pd(vz, vz)));
+            auto const inside = _mm256_cmp_pd(r, vrmin, _CMP_GE_OQ);
+
+            // 動径部分：等間隔の表をgatherして線形補間する
+            auto const t = _mm256_mul_pd(r, vinvdr);
+            auto const k = _mm256_cvttpd_epi32(t);
+            auto const f = _mm256_sub_pd(t, _mm256_cvtepi32_pd(k));
+            auto const f0 = _mm256_i32gather_pd(radial_.data(), k, 8);
+            auto const f1 = _mm256_i32gather_pd(radial_.data() + 1, k, 8);
+            auto const rad = _mm256_add_pd(f0, _mm256_mul_pd(f, _mm256_sub_pd(f1, f0)));
+
+            // 角度部分：cosθ = z / rの多項式と、(x + iy)^|m| / r^|m|
+            auto const invr = _mm256_div_pd(vone, _mm256_max_pd(r, vrmin));
+            auto const c = _mm256_mul_pd(vz, invr);
+            auto qm1 = _mm256_setzero_pd();
+            auto q = vone;
+            for (auto l = absm_ + 1; l <= l_; l++) {
+                auto const qn = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(a_[l]), _mm256_mul_pd(c, q)), _mm256_mul_pd(_mm256_set1_pd(b_[l]), qm1));
+                qm1 = q;
+                q = qn;
+            }
+
+            auto re = vone, im = _mm256_setzero_pd();
+            auto const vxr = _mm256_mul_pd(vx, invr);
+            auto const vyr = _mm256_mul_pd(vy, invr);
+            for (auto i = 0U; i < absm_; i++) {
+                auto const ren = _mm256_sub_pd(_mm256_mul_pd(re, vxr), _mm256_mul_pd(im, vyr));
+                im = _mm256_add_pd(_mm256_mul_pd(re, vyr), _mm256_mul_pd(im, vxr));
+                re = ren;
+            }
+
+            auto const ang = _mm256_mul_pd(vc, _mm256_mul_pd(q, sine_ ? im : re));
+            auto v = _mm256_mul_pd(rad, rho_ ? _mm256_mul_pd(ang, ang) : ang);
+            v = _mm256_and_pd(v, inside);
+            _mm256_storeu_pd(val + j, v);
+
+            // 採否のマスク：|値| >= u
+            auto const accept = _mm256_cmp_pd(_mm256_and_pd(v, vabs), _mm256_loadu_pd(u + j), _CMP_GE_OQ);
+            mask |= static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_and_pd(accept, inside))) << j;
+        }
+
+        return mask;
+#else
+        return AcceptPortable(x, y, z, u, val);
+#endif
+    }
+
+    std::uint32_t BatchRejection::AcceptPortable(double const * x, double const * y, double const * z, double const * u, double * val) const
+    {
+        auto mask = 0U;
+        for (auto i = 0U; i < BATCH; i++) {
+            auto const r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            if (r < rmin_) {
+                val[i] = 0.0;
+                continue;
+            }
+
+            auto const t = r * invdr_;
+            auto const k = static_cast<std::size_t>(t);
+            auto const rad = radial_[k] + (t - static_cast<double>(k)) * (radial_[k + 1] - radial_[k]);
+            auto const ang = c_ * Angular(x[i], y[i], z[i]);
+
+            val[i] = rho_ ? rad * ang * ang : rad * ang;
+            if (std::fabs(val[i]) >= u[i]) {
+                mask |= 1U << i;
+            }
+        }
+
+        return mask;
+    }
+
+    double BatchRejection::Angular(double x, double y, double z) const
+    {
+        auto const r = std::sqrt(x * x + y * y + z * z);
+        if (r <= 0.0) {
+            return 0.0;
+        }
+
+        auto const c = z / r;
+        auto qm1 = 0.0, q = 1.0;
+        for (auto l = absm_ + 1; l <= l_; l++) {
+            auto const qn = a_[l] * c * q - b_[l] * qm1;
+            qm1 = q;
+            q = qn;
+        }
+
+        auto re = 1.0, im = 0.0;
+        for (auto i = 0U; i < absm_; i++) {
+            auto const ren = re * x / r - im * y / r;
+            im = re * y / r + im * x / r;
+            re = ren;
+        }
+
+        return q * (sine_ ? im : re);
+    }
+
+    bool BatchRejection::HasAvx2()
+    {
+#if defined(SAMPLER_AVX2_KERNEL) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+
+        // OSがYMMレジスタを保存するか（OSXSAVEとAVX、XCR0のビット1と2）
+        auto const osxsave = (info[2] & (1 << 27)) != 0;
+        auto const avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(SAMPLER_AVX2_KERNEL)
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }
+
+    // #endregion メンバ関数
+}
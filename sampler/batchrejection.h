@@ -0,0 +1,247 @@
+﻿/*! \file batchrejection.h
+    \brief 候補をまとめて評価する、SIMD化された棄却法のカーネルクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BATCHREJECTION_H_
+#define _BATCHREJECTION_H_
+
+#pragma once
+
+#include "balldomain.h"
+#include "../getdata/getdata.h"
+#include "../myrandom/xoshiro256.h"
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        球内の候補をBATCH個ずつ生成し、レーンごとに目的の分布を評価して、採択された点だけを詰めて出力するクラス
+        acos、atan2、GSLのスプラインとBoostの球面調和関数を使わずに済むよう、
+        動径部分は等間隔の表の線形補間で、角度部分はデカルト座標の多項式で計算する
+        AVX2が使えるCPUではAVX2のカーネルを、そうでなければ移植性のあるカーネルを使う
+    */
+    class BatchRejection final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param gd データオブジェクト
+            \param m 磁気量子数
+            \param sine 角度部分にsin(|m|φ)を使うかどうか（falseならcos(|m|φ)）
+            \param radius 候補を生成する球の半径
+            \param envelope 目的の分布の上限（安全係数込み）
+        */
+        BatchRejection(getdata::GetData const & gd, std::int32_t m, bool sine, double radius, double envelope);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BatchRejection() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            BATCH個の候補を生成して評価し、採択された点を先頭から詰めて書き込む
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param x 採択された点のx座標の出力先（BATCH個分の領域が必要）
+            \param y 採択された点のy座標の出力先（BATCH個分の領域が必要）
+            \param z 採択された点のz座標の出力先（BATCH個分の領域が必要）
+            \param sign 採択された点の波動関数の符号の出力先（BATCH個分の領域が必要）
+            \return 採択された点の数
+        */
+        std::size_t operator()(myrandom::Xoshiro256 & rs, double * x, double * y, double * z, std::int32_t * sign) const;
+
+        //!  A public member function (const).
+        /*!
+            AVX2のカーネルを使っているかどうかを返す
+            \return AVX2のカーネルを使っているならtrue
+        */
+        bool Avx2() const
+        {
+            return avx2_;
+        }
+
+    private:
+        //!  A private member function (const).
+        /*!
+            AVX2で、BATCH個の候補での目的の分布の値を求め、採否のマスクを作る
+            \param x 候補のx座標
+            \param y 候補のy座標
+            \param z 候補のz座標
+            \param u 候補ごとの[0, envelope)の一様乱数
+            \param val 目的の分布の値の出力先
+            \return 採択された候補のビットが立ったマスク
+        */
+        std::uint32_t AcceptAvx2(double const * x, double const * y, double const * z, double const * u, double * val) const;
+
+        //!  A private member function (const).
+        /*!
+            移植性のあるコードで、BATCH個の候補での目的の分布の値を求め、採否のマスクを作る
+            \param x 候補のx座標
+            \param y 候補のy座標
+            \param z 候補のz座標
+            \param u 候補ごとの[0, envelope)の一様乱数
+            \param val 目的の分布の値の出力先
+            \return 採択された候補のビットが立ったマスク
+        */
+        std::uint32_t AcceptPortable(double const * x, double const * y, double const * z, double const * u, double * val) const;
+
+        //!  A private member function (const).
+        /*!
+            候補の点での角度部分の形（定数倍を除く）を求める
+            \param x x座標
+            \param y y座標
+            \param z z座標
+            \return 角度部分の形
+        */
+        double Angular(double x, double y, double z) const;
+
+        //!  A private static member function.
+        /*!
+            CPUとOSがAVX2に対応しているかどうかを調べる
+            \return AVX2が使えるならtrue
+        */
+        static bool HasAvx2();
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    public:
+        //! A public static member variable (constant).
+        /*!
+            一度に評価する候補の数（AVX2の倍精度4レーン×2）
+        */
+        static std::size_t const BATCH = 8;
+
+        //! A public static member variable (constant).
+        /*!
+            動径部分の表の区間の数
+        */
+        static std::size_t const NRADIAL = 8192;
+
+    private:
+        //! A private member variable.
+        /*!
+            Legendre陪関数の漸化式の係数（(2l - 1) / (l - |m|)）
+        */
+        std::vector<double> a_;
+
+        //! A private member variable.
+        /*!
+            |m|
+        */
+        std::uint32_t absm_;
+
+        //! A private member variable.
+        /*!
+            AVX2のカーネルを使うかどうか
+        */
+        bool avx2_;
+
+        //! A private member variable.
+        /*!
+            Legendre陪関数の漸化式の係数（(l + |m| - 1) / (l - |m|)）
+        */
+        std::vector<double> b_;
+
+        //! A private member variable.
+        /*!
+            候補を生成する球
+        */
+        BallDomain ball_;
+
+        //! A private member variable.
+        /*!
+            角度部分の形をBoostの球面調和関数に合わせるための定数
+        */
+        double c_;
+
+        //! A private member variable.
+        /*!
+            目的の分布の上限
+        */
+        double envelope_;
+
+        //! A private member variable.
+        /*!
+            動径部分の表の刻み幅の逆数
+        */
+        double invdr_;
+
+        //! A private member variable.
+        /*!
+            方位量子数
+        */
+        std::uint32_t l_;
+
+        //! A private member variable.
+        /*!
+            動径部分の表（r = 0から等間隔、最後に番兵の0を一つ置く）
+        */
+        std::vector<double> radial_;
+
+        //! A private member variable.
+        /*!
+            電子密度かどうか（trueなら角度部分を二乗し、符号は常に正）
+        */
+        bool rho_;
+
+        //! A private member variable.
+        /*!
+            メッシュの最小値（これより内側の候補は棄却する）
+        */
+        double rmin_;
+
+        //! A private member variable.
+        /*!
+            角度部分にsin(|m|φ)を使うかどうか
+        */
+        bool sine_;
+
+        //! A private member variable.
+        /*!
+            角度部分が恒等的に0かどうか（sin(0φ)の場合）
+        */
+        bool zero_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        BatchRejection() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        BatchRejection(BatchRejection const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        BatchRejection & operator=(BatchRejection const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _BATCHREJECTION_H_
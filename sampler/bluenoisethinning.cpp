@@ -0,0 +1,367 @@
+﻿/*! \file bluenoisethinning.cpp
+    \brief 多めに生成した点の集合を、密度に適応した最小距離のブルーノイズな部分集合に間引くクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "bluenoisethinning.h"
+#include <algorithm>                // for std::fill, std::max, std::min, std::nth_element
+#include <cmath>                    // for std::cbrt, std::ceil, std::exp, std::floor, std::log, std::sqrt
+#include <limits>                   // for std::numeric_limits
+#include <tbb/parallel_for.h>       // for tbb::parallel_for
+
+namespace sampler {
+    double const BlueNoiseThinning::QUANTILE = 0.1;
+    double const BlueNoiseThinning::TOLERANCE = 0.005;
+
+    // #region メンバ関数
+
+    std::vector<std::size_t> BlueNoiseThinning::operator()(std::size_t target, cancel_type const & cancelled)
+    {
+        auto const n = x_.size();
+        std::vector<std::size_t> indices;
+
+        iterations_ = 0;
+        if (target >= n) {
+            indices.resize(n);
+            for (auto i = 0U; i < n; i++) {
+                indices[i] = i;
+            }
+
+            return indices;
+        }
+
+        // 倍率と選ばれる点の数の両対数での傾きを割線法で見積もって、次の倍率を決める
+        // 目標を挟む区間の外に出る場合は、二分法に切り替える
+        auto lo = 0.0, hi = std::numeric_limits<double>::max();
+        auto c = 1.0, slope = -3.0;
+        auto cprev = 0.0, countprev = 0.0;
+        auto count = n;
+        for (; iterations_ < MAXITER; iterations_++) {
+            // 中止されたら、途中までの結果は使わずに空の配列を返す
+            if (cancelled()) {
+                return indices;
+            }
+
+            count = Throw(c, cancelled);
+            if (cancelled()) {
+                return indices;
+            }
+
+            if (static_cast<double>(count > target ? count - target : target - count) <= TOLERANCE * static_cast<double>(target)) {
+                iterations_++;
+                break;
+            }
+
+            if (count > target) {
+                lo = c;
+            }
+            else {
+                hi = c;
+            }
+
+            auto const logcount = std::log(static_cast<double>(std::max(count, std::size_t(1))));
+            if (cprev > 0.0 && c != cprev && logcount != countprev) {
+                slope = std::min((logcount - countprev) / (std::log(c) - std::log(cprev)), -0.5);
+            }
+            cprev = c;
+            countprev = logcount;
+
+            auto const next = c * std::exp((std::log(static_cast<double>(target)) - logcount) / slope);
+            c = next > lo && next < hi ? next : 0.5 * (lo + std::min(hi, 2.0 * std::max(lo, c)));
+        }
+
+        // 最後の結果が目標より少なければ、目標より多く選ばれる側の倍率でやり直す
+        if (count < target && lo > 0.0) {
+            count = Throw(lo, cancelled);
+            iterations_++;
+            if (cancelled()) {
+                return indices;
+            }
+        }
+
+        if (count < target) {
+            // 目標より多く選ばれる倍率が見つからなかった（多くの点が重なっている場合など）ので、すべての点から選ぶ
+            count = n;
+            indices.resize(n);
+            for (auto i = 0U; i < n; i++) {
+                indices[i] = i;
+            }
+        }
+        else {
+            indices.reserve(count);
+            for (auto c = 0U; c < naccepted_.size(); c++) {
+                for (auto k = cellstart_[c]; k < cellstart_[c] + naccepted_[c]; k++) {
+                    indices.push_back(accepted_[k]);
+                }
+            }
+        }
+
+        // 多すぎる分は、格子の順に等間隔に取り除く
+        if (indices.size() > target) {
+            for (auto k = 0U; k < target; k++) {
+                indices[k] = indices[static_cast<std::size_t>(static_cast<double>(k) * static_cast<double>(count) / static_cast<double>(target))];
+            }
+            indices.resize(target);
+        }
+
+        return indices;
+    }
+
+    double BlueNoiseThinning::Uniformity(std::vector<std::size_t> const & indices, cancel_type const & cancelled) const
+    {
+        auto const ncell = cellstart_.size() - 1;
+
+        // 部分集合の点だけを、今の格子に振り分け直す
+        std::vector<std::uint32_t> start(ncell + 1, 0), sorted(indices.size());
+        std::vector<std::size_t> cells(indices.size());
+        for (auto k = 0U; k < indices.size(); k++) {
+            cells[k] = Cell(indices[k]);
+            start[cells[k] + 1]++;
+        }
+        for (auto c = 0U; c < ncell; c++) {
+            start[c + 1] += start[c];
+        }
+
+        std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+        for (auto k = 0U; k < indices.size(); k++) {
+            sorted[fill[cells[k]]++] = static_cast<std::uint32_t>(indices[k]);
+        }
+
+        // 点ごとに、近傍の格子の中での最近接距離を点の間隔で規格化する（見つからなければ負）
+        std::vector<double> nn(indices.size());
+        tbb::parallel_for(
+            std::size_t(0),
+            indices.size(),
+            [&](std::size_t k) {
+                if (cancelled()) {
+                    nn[k] = -1.0;
+                    return;
+                }
+
+                auto const p = indices[k];
+                auto const c = cells[k];
+                auto const ix = static_cast<std::int32_t>(c % ngrid_);
+                auto const iy = static_cast<std::int32_t>((c / ngrid_) % ngrid_);
+                auto const iz = static_cast<std::int32_t>(c / (static_cast<std::size_t>(ngrid_) * ngrid_));
+
+                auto dmin2 = std::numeric_limits<double>::max();
+                for (auto jz = std::max(iz - RANGE, 0); jz <= std::min(iz + RANGE, ngrid_ - 1); jz++) {
+                    for (auto jy = std::max(iy - RANGE, 0); jy <= std::min(iy + RANGE, ngrid_ - 1); jy++) {
+                        for (auto jx = std::max(ix - RANGE, 0); jx <= std::min(ix + RANGE, ngrid_ - 1); jx++) {
+                            auto const nc = (static_cast<std::size_t>(jz) * ngrid_ + jy) * ngrid_ + jx;
+                            for (auto a = start[nc]; a < start[nc + 1]; a++) {
+                                auto const q = sorted[a];
+                                if (q == p) {
+                                    continue;
+                                }
+
+                                auto const dx = static_cast<double>(x_[q] - x_[p]);
+                                auto const dy = static_cast<double>(y_[q] - y_[p]);
+                                auto const dz = static_cast<double>(z_[q] - z_[p]);
+                                dmin2 = std::min(dmin2, dx * dx + dy * dy + dz * dz);
+                            }
+                        }
+                    }
+                }
+
+                nn[k] = dmin2 < std::numeric_limits<double>::max() ? std::sqrt(dmin2) / static_cast<double>(spacing_[p]) : -1.0;
+            });
+
+        if (cancelled()) {
+            return 0.0;
+        }
+
+        auto sum = 0.0, sum2 = 0.0;
+        auto count = 0U;
+        for (auto const d : nn) {
+            if (d >= 0.0) {
+                sum += d;
+                sum2 += d * d;
+                count++;
+            }
+        }
+
+        if (count < 2 || sum <= 0.0) {
+            return 0.0;
+        }
+
+        auto const mean = sum / static_cast<double>(count);
+        return std::sqrt(std::max(sum2 / static_cast<double>(count) - mean * mean, 0.0)) / mean;
+    }
+
+    void BlueNoiseThinning::Bin(double width, cancel_type const & cancelled)
+    {
+        auto const n = x_.size();
+
+        // 幅が0に近くても整数への変換で溢れないよう、格子の数は浮動小数点数のまま上限で抑えてから変換する
+        auto const ngrid = width > 0.0 ? std::ceil(2.0 * halfwidth_ / width) : static_cast<double>(MAXGRID);
+        ngrid_ = std::max(1, static_cast<std::int32_t>(std::min(ngrid, static_cast<double>(MAXGRID))));
+        width_ = 2.0 * halfwidth_ / static_cast<double>(ngrid_);
+
+        auto const ncell = static_cast<std::size_t>(ngrid_) * ngrid_ * ngrid_;
+        cellstart_.assign(ncell + 1, 0);
+        naccepted_.assign(ncell, 0);
+
+        // 計数ソートで点を格子の順に並べる（格子の中では元の順のまま）
+        // 中止されたら、それまでに数えた点だけを並べる
+        std::vector<std::size_t> cells(n);
+        auto binned = n;
+        for (auto i = 0U; i < n; i++) {
+            if (cancelled()) {
+                binned = i;
+                break;
+            }
+
+            cells[i] = Cell(i);
+            cellstart_[cells[i] + 1]++;
+        }
+        for (auto c = 0U; c < ncell; c++) {
+            cellstart_[c + 1] += cellstart_[c];
+        }
+
+        order_.resize(n);
+        std::vector<std::uint32_t> fill(cellstart_.begin(), cellstart_.end() - 1);
+        for (auto i = 0U; i < binned; i++) {
+            order_[fill[cells[i]]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    void BlueNoiseThinning::Build(density_type const & density)
+    {
+        auto const n = x_.size();
+        accepted_.resize(n);
+        spacing_.resize(n);
+        if (!n) {
+            Bin(2.0 * halfwidth_, [] { return false; });
+            return;
+        }
+
+        std::vector<double> p(n);
+        tbb::parallel_for(
+            std::size_t(0),
+            n,
+            [&](std::size_t i) { p[i] = density(x_[i], y_[i], z_[i]); });
+
+        // 粗い格子で数えた点の密度と、分布の値の比の中央値を比例係数とする
+        Bin(2.0 * halfwidth_ / static_cast<double>(NCOARSE), [] { return false; });
+        auto const volume = width_ * width_ * width_;
+        std::vector<double> counted(n), ratio;
+        ratio.reserve(n);
+        for (auto c = 0U; c + 1 < cellstart_.size(); c++) {
+            for (auto k = cellstart_[c]; k < cellstart_[c + 1]; k++) {
+                auto const i = order_[k];
+                counted[i] = static_cast<double>(cellstart_[c + 1] - cellstart_[c]) / volume;
+                if (p[i] > 0.0) {
+                    ratio.push_back(counted[i] / p[i]);
+                }
+            }
+        }
+
+        // 分布が恒等的に0の場合は、粗い格子で数えた密度をそのまま使う
+        auto scale = 0.0;
+        if (!ratio.empty()) {
+            std::nth_element(ratio.begin(), ratio.begin() + ratio.size() / 2, ratio.end());
+            scale = ratio[ratio.size() / 2];
+        }
+
+        for (auto i = 0U; i < n; i++) {
+            auto const rho = ratio.empty() ? counted[i] : scale * p[i];
+            spacing_[i] = rho > 0.0 ? static_cast<float>(1.0 / std::cbrt(rho)) : std::numeric_limits<float>::max();
+        }
+
+        // 格子の幅は、密度の高い方からQUANTILEの位置にある点の間隔を基準にする
+        std::vector<float> sorted(spacing_);
+        auto const q = static_cast<std::size_t>(QUANTILE * static_cast<double>(n - 1));
+        std::nth_element(sorted.begin(), sorted.begin() + q, sorted.end());
+        refspacing_ = static_cast<double>(sorted[q]);
+    }
+
+    std::size_t BlueNoiseThinning::Cell(std::size_t i) const
+    {
+        auto const index = [this](float x) {
+            auto const k = static_cast<std::int32_t>(std::floor((static_cast<double>(x) + halfwidth_) / width_));
+            return static_cast<std::size_t>(std::max(0, std::min(k, ngrid_ - 1)));
+        };
+
+        return (index(z_[i]) * ngrid_ + index(y_[i])) * ngrid_ + index(x_[i]);
+    }
+
+    std::size_t BlueNoiseThinning::Throw(double c, cancel_type const & cancelled)
+    {
+        // 密度の高い領域の最小距離が格子の幅程度になるように、倍率ごとに格子を作り直す
+        Bin(c * refspacing_, cancelled);
+
+        auto const rcap = static_cast<double>(RANGE) * width_;
+        auto const radius = [this, c, rcap](std::uint32_t i) { return std::min(c * static_cast<double>(spacing_[i]), rcap); };
+
+        // RANGE個ずつの格子をブロックにまとめる
+        // x, y, zの添字の偶奇が等しいブロックの間には別のブロックが挟まるので、同時に処理しても互いの近傍に入らない
+        auto const nblock = (ngrid_ + RANGE - 1) / RANGE;
+        auto const nhalf = (nblock + 1) / 2;
+
+        for (auto phase = 0; phase < 8 && !cancelled(); phase++) {
+            tbb::parallel_for(
+                0,
+                nhalf * nhalf * nhalf,
+                [&](std::int32_t t) {
+                    auto const bx = (phase & 1) + 2 * (t % nhalf);
+                    auto const by = ((phase >> 1) & 1) + 2 * ((t / nhalf) % nhalf);
+                    auto const bz = (phase >> 2) + 2 * (t / (nhalf * nhalf));
+                    if (bx >= nblock || by >= nblock || bz >= nblock) {
+                        return;
+                    }
+
+                    for (auto iz = bz * RANGE; iz < std::min((bz + 1) * RANGE, ngrid_); iz++) {
+                        for (auto iy = by * RANGE; iy < std::min((by + 1) * RANGE, ngrid_); iy++) {
+                            for (auto ix = bx * RANGE; ix < std::min((bx + 1) * RANGE, ngrid_); ix++) {
+                                auto const cell = (static_cast<std::size_t>(iz) * ngrid_ + iy) * ngrid_ + ix;
+                                // 密度の高いブロックは一つでも時間がかかるので、点ごとにも中止を確かめる
+                                for (auto k = cellstart_[cell]; k < cellstart_[cell + 1] && !cancelled(); k++) {
+                                    auto const p = order_[k];
+                                    auto const rp = radius(p);
+                                    auto const range = static_cast<std::int32_t>(std::ceil(rp / width_));
+
+                                    // 二点の最小距離のうち小さい方より近くに、すでに選ばれた点があれば棄却する
+                                    auto rejected = false;
+                                    for (auto jz = std::max(iz - range, 0); jz <= std::min(iz + range, ngrid_ - 1) && !rejected; jz++) {
+                                        for (auto jy = std::max(iy - range, 0); jy <= std::min(iy + range, ngrid_ - 1) && !rejected; jy++) {
+                                            for (auto jx = std::max(ix - range, 0); jx <= std::min(ix + range, ngrid_ - 1) && !rejected; jx++) {
+                                                auto const nc = (static_cast<std::size_t>(jz) * ngrid_ + jy) * ngrid_ + jx;
+                                                for (auto a = cellstart_[nc]; a < cellstart_[nc] + naccepted_[nc]; a++) {
+                                                    auto const q = accepted_[a];
+                                                    auto const d = std::min(rp, radius(q));
+                                                    auto const dx = static_cast<double>(x_[q] - x_[p]);
+                                                    auto const dy = static_cast<double>(y_[q] - y_[p]);
+                                                    auto const dz = static_cast<double>(z_[q] - z_[p]);
+                                                    if (dx * dx + dy * dy + dz * dz < d * d) {
+                                                        rejected = true;
+                                                        break;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    if (!rejected) {
+                                        accepted_[cellstart_[cell] + naccepted_[cell]++] = p;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+        }
+
+        auto total = static_cast<std::size_t>(0);
+        for (auto const a : naccepted_) {
+            total += a;
+        }
+
+        return total;
+    }
+
+    // #endregion メンバ関数
+}
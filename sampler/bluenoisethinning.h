@@ -0,0 +1,280 @@
+﻿/*! \file bluenoisethinning.h
+    \brief 多めに生成した点の集合を、密度に適応した最小距離のブルーノイズな部分集合に間引くクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _BLUENOISETHINNING_H_
+#define _BLUENOISETHINNING_H_
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <functional>   // for std::function
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        多めに生成した点から、ダーツ投げ法（Poissonディスク）で点を選んで間引くクラス
+        最小距離は点の密度の-1/3乗に比例させるので、間引いた後も分布の形は変わらない
+        点の密度には目的の分布の値を使い、その比例係数は粗い格子で数えた点の数から見積もる
+        近傍の探索には格子を使い、格子のブロックを偶奇で8つの段階に分けてTBBで並列に処理する
+    */
+    class BlueNoiseThinning final {
+        // #region 型エイリアス
+
+    public:
+        using cancel_type = std::function<bool()>;
+        using density_type = std::function<double(double, double, double)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param vertices 間引く前の点の配列（各要素はPos.x, Pos.y, Pos.zを持つ）
+            \param density 点が従う分布（定数倍は問わない、非負の値を返すこと）
+            \param halfwidth 点を含む立方体の一辺の長さの半分
+        */
+        template <typename Vertex>
+        BlueNoiseThinning(std::vector<Vertex> const & vertices, density_type const & density, double halfwidth) :
+            halfwidth_(halfwidth),
+            x_(vertices.size()),
+            y_(vertices.size()),
+            z_(vertices.size())
+        {
+            for (auto i = 0U; i < vertices.size(); i++) {
+                x_[i] = vertices[i].Pos.x;
+                y_[i] = vertices[i].Pos.y;
+                z_[i] = vertices[i].Pos.z;
+            }
+
+            Build(density);
+        }
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~BlueNoiseThinning() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            最小距離の倍率を二分法で調整して、target個に近い数の点を選ぶ
+            選ばれた点がtarget個より多い場合は、格子の順に等間隔に間引いてちょうどtarget個にする
+            中止は、ダーツ投げ法の合間と、その8つの段階の合間（と段階の中の点ごと）に確かめる
+            \param target 選ぶ点の数
+            \param cancelled 中止が要求されていればtrueを返す関数
+            \return 選ばれた点の添字（格子の順、中止された場合は空）
+        */
+        std::vector<std::size_t> operator()(std::size_t target, cancel_type const & cancelled);
+
+        //!  A public member function (const).
+        /*!
+            ダーツ投げ法を行った回数を返す
+            \return ダーツ投げ法を行った回数
+        */
+        std::int32_t Iterations() const
+        {
+            return iterations_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            点の部分集合の均一さとして、点の密度で規格化した最近接距離の変動係数を求める
+            一様なPoisson過程では約0.52になり、ブルーノイズでは小さくなる
+            \param indices 部分集合の点の添字
+            \param cancelled 中止が要求されていればtrueを返す関数（点ごとに確かめる）
+            \return 規格化した最近接距離の変動係数（最近接点が近傍の格子にない点は除く、中止された場合は0）
+        */
+        double Uniformity(std::vector<std::size_t> const & indices, cancel_type const & cancelled) const;
+
+    private:
+        //!  A private member function.
+        /*!
+            点を一辺の長さがwidth程度の格子に振り分ける
+            \param width 格子の一辺の長さ
+            \param cancelled 中止が要求されていればtrueを返す関数（中止されたら、振り分けは途中のままになる）
+        */
+        void Bin(double width, cancel_type const & cancelled);
+
+        //!  A private member function.
+        /*!
+            点ごとの密度と、最小距離の基準になる点の間隔を求める
+            \param density 点が従う分布
+        */
+        void Build(density_type const & density);
+
+        //!  A private member function (const).
+        /*!
+            点の座標から格子の添字を求める（立方体の外側の点は端の格子に入れる）
+            \param i 点の添字
+            \return 格子の添字
+        */
+        std::size_t Cell(std::size_t i) const;
+
+        //!  A private member function.
+        /*!
+            最小距離の倍率を固定してダーツ投げ法を一回行う
+            \param c 最小距離の倍率（点の間隔に対する比）
+            \param cancelled 中止が要求されていればtrueを返す関数（中止されたら、途中までの結果を返す）
+            \return 選ばれた点の数
+        */
+        std::size_t Throw(double c, cancel_type const & cancelled);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private static member variable (constant).
+        /*!
+            二分法の反復の最大回数
+        */
+        static std::int32_t const MAXITER = 20;
+
+        //! A private static member variable (constant).
+        /*!
+            一辺あたりの格子の数の最大値
+        */
+        static std::int32_t const MAXGRID = 128;
+
+        //! A private static member variable (constant).
+        /*!
+            密度の比例係数を見積もる粗い格子の、一辺あたりの数
+        */
+        static std::int32_t const NCOARSE = 16;
+
+        //! A private static member variable (constant).
+        /*!
+            近傍を探す範囲（格子の数）、最小距離はこれに格子の幅をかけたもので頭打ちにする
+        */
+        static std::int32_t const RANGE = 5;
+
+        //! A private static member variable (constant).
+        /*!
+            格子の幅を決める点の間隔の分位点（密度の高い方からの割合）
+        */
+        static double const QUANTILE;
+
+        //! A private static member variable (constant).
+        /*!
+            選ぶ点の数の、目標に対する許容誤差
+        */
+        static double const TOLERANCE;
+
+        //! A private member variable.
+        /*!
+            ダーツ投げ法で選ばれた点の添字（格子ごとにcellstart_から詰める）
+        */
+        std::vector<std::uint32_t> accepted_;
+
+        //! A private member variable.
+        /*!
+            格子ごとの、点の添字の先頭の位置（末尾は点の数）
+        */
+        std::vector<std::uint32_t> cellstart_;
+
+        //! A private member variable.
+        /*!
+            立方体の一辺の長さの半分
+        */
+        double halfwidth_;
+
+        //! A private member variable.
+        /*!
+            ダーツ投げ法を行った回数
+        */
+        std::int32_t iterations_ = 0;
+
+        //! A private member variable.
+        /*!
+            格子ごとの、ダーツ投げ法で選ばれた点の数
+        */
+        std::vector<std::uint32_t> naccepted_;
+
+        //! A private member variable.
+        /*!
+            一辺あたりの格子の数
+        */
+        std::int32_t ngrid_ = 1;
+
+        //! A private member variable.
+        /*!
+            格子の順に並べた点の添字
+        */
+        std::vector<std::uint32_t> order_;
+
+        //! A private member variable.
+        /*!
+            格子の幅を決める基準の点の間隔
+        */
+        double refspacing_ = 1.0;
+
+        //! A private member variable.
+        /*!
+            点ごとの、密度の-1/3乗（点の平均的な間隔）
+        */
+        std::vector<float> spacing_;
+
+        //! A private member variable.
+        /*!
+            格子の幅
+        */
+        double width_ = 1.0;
+
+        //! A private member variable.
+        /*!
+            点のx座標
+        */
+        std::vector<float> x_;
+
+        //! A private member variable.
+        /*!
+            点のy座標
+        */
+        std::vector<float> y_;
+
+        //! A private member variable.
+        /*!
+            点のz座標
+        */
+        std::vector<float> z_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        BlueNoiseThinning() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        BlueNoiseThinning(BlueNoiseThinning const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        BlueNoiseThinning & operator=(BlueNoiseThinning const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _BLUENOISETHINNING_H_
@@ -0,0 +1,101 @@
+﻿/*! \file cartesianylm.cpp
+    \brief デカルト座標の多項式で表した実数の球面調和関数クラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "cartesianylm.h"
+#include <cmath>                                // for std::sqrt
+#include <cstdlib>                              // for std::abs
+#include <boost/assert.hpp>                     // for BOOST_ASSERT
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace sampler {
+    namespace {
+        using table_type = std::array<std::array<std::array<CartesianYlm::function_type, 2>, CartesianYlm::LMAX + 1>, CartesianYlm::LMAX + 1>;
+
+        //! A struct.
+        /*!
+            (L, M)から(0, 0)までの特殊化された関数を、表に再帰的に詰めるテンプレート
+        */
+        template <std::int32_t L, std::int32_t M>
+        struct TableFiller final {
+            static void Fill(table_type & table)
+            {
+                table[L][M][0] = &YlmShape<L, M, false>;
+                table[L][M][1] = &YlmShape<L, M, true>;
+                TableFiller<L, M - 1>::Fill(table);
+            }
+        };
+
+        template <std::int32_t L>
+        struct TableFiller<L, -1> final {
+            static void Fill(table_type & table)
+            {
+                TableFiller<L - 1, L - 1>::Fill(table);
+            }
+        };
+
+        template <>
+        struct TableFiller<-1, -1> final {
+            static void Fill(table_type &)
+            {
+            }
+        };
+
+        //! A function.
+        /*!
+            特殊化された関数の表を作る
+            \return 特殊化された関数の表
+        */
+        table_type MakeTable()
+        {
+            table_type table = {};
+            TableFiller<CartesianYlm::LMAX, CartesianYlm::LMAX>::Fill(table);
+            return table;
+        }
+    }
+
+    // #region コンストラクタ
+
+    CartesianYlm::CartesianYlm(std::uint32_t l, std::int32_t m, bool sine)
+    {
+        BOOST_ASSERT(l <= LMAX);
+
+        static auto const table = MakeTable();
+
+        auto const absm = static_cast<std::uint32_t>(std::abs(m));
+        func_ = table[l][absm][sine ? 1 : 0];
+
+        // sqrt((2l + 1) / 4π × (l - |m|)! / (l + |m|)!) × (2|m| - 1)!! × (-1)^|m|（Condon-Shortleyの位相）
+        auto ratio = 1.0;
+        for (auto k = l - absm + 1; k <= l + absm; k++) {
+            ratio /= static_cast<double>(k);
+        }
+
+        auto dfact = 1.0;
+        for (auto k = 1U; k < 2 * absm; k += 2) {
+            dfact *= static_cast<double>(k);
+        }
+
+        coef_ = std::sqrt(static_cast<double>(2 * l + 1) / (4.0 * boost::math::constants::pi<double>()) * ratio) * dfact;
+        if (absm & 1U) {
+            coef_ = -coef_;
+        }
+
+        // m < 0の場合はY_l^{-|m|} = (-1)^|m| conj(Y_l^|m|)なので、虚部はさらに符号が反転する
+        if (m < 0) {
+            if (absm & 1U) {
+                coef_ = -coef_;
+            }
+
+            if (sine) {
+                coef_ = -coef_;
+            }
+        }
+    }
+
+    // #endregion コンストラクタ
+}
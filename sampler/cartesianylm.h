@@ -0,0 +1,186 @@
+﻿/*! \file cartesianylm.h
+    \brief デカルト座標の多項式で表した実数の球面調和関数クラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _CARTESIANYLM_H_
+#define _CARTESIANYLM_H_
+
+#pragma once
+
+#include <array>    // for std::array
+#include <cstdint>  // for std::int32_t, std::uint32_t
+
+namespace sampler {
+    //! A struct.
+    /*!
+        Legendre陪関数P_l^mをsin^mθで割った多項式（cosθの多項式）を、D = l - mについての漸化式で展開するテンプレート
+        定数倍（(2m - 1)!!とCondon-Shortleyの位相）はCartesianYlmの係数に含める
+    */
+    template <std::int32_t D, std::int32_t M>
+    struct LegendreQ final {
+        static double Value(double c)
+        {
+            return (static_cast<double>(2 * (M + D) - 1) * c * LegendreQ<D - 1, M>::Value(c) -
+                    static_cast<double>(2 * M + D - 1) * LegendreQ<D - 2, M>::Value(c)) / static_cast<double>(D);
+        }
+    };
+
+    template <std::int32_t M>
+    struct LegendreQ<1, M> final {
+        static double Value(double c)
+        {
+            return static_cast<double>(2 * M + 1) * c;
+        }
+    };
+
+    template <std::int32_t M>
+    struct LegendreQ<0, M> final {
+        static double Value(double)
+        {
+            return 1.0;
+        }
+    };
+
+    //! A struct.
+    /*!
+        (x + iy)^mの実部と虚部（単位ベクトルならcos(mφ)sin^mθとsin(mφ)sin^mθ）を展開するテンプレート
+    */
+    template <std::int32_t M>
+    struct Azimuthal final {
+        static void Value(double x, double y, double & re, double & im)
+        {
+            double r, i;
+            Azimuthal<M - 1>::Value(x, y, r, i);
+            re = r * x - i * y;
+            im = r * y + i * x;
+        }
+    };
+
+    template <>
+    struct Azimuthal<0> final {
+        static void Value(double, double, double & re, double & im)
+        {
+            re = 1.0;
+            im = 0.0;
+        }
+    };
+
+    //! A function template.
+    /*!
+        単位ベクトル(x, y, z)での、実数の球面調和関数の形（定数倍を除く）
+        \param x 単位ベクトルのx成分
+        \param y 単位ベクトルのy成分
+        \param z 単位ベクトルのz成分
+        \return Sineがfalseなら P_l^m / sin^mθ × Re(x + iy)^m、trueなら虚部を使ったもの
+    */
+    template <std::int32_t L, std::int32_t M, bool Sine>
+    double YlmShape(double x, double y, double z)
+    {
+        double re, im;
+        Azimuthal<M>::Value(x, y, re, im);
+        return LegendreQ<L - M, M>::Value(z) * (Sine ? im : re);
+    }
+
+    //! A class.
+    /*!
+        l ≦ LMAXの実数の球面調和関数を、単位ベクトルの成分の多項式で評価するクラス
+        (l, |m|, sin/cos)ごとに特殊化された関数を、構築時に一度だけ表から選ぶ
+        値はboost::math::spherical_harmonic_r、spherical_harmonic_iと一致する
+    */
+    class CartesianYlm final {
+        // #region 型エイリアス
+
+    public:
+        using function_type = double (*)(double, double, double);
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param l 方位量子数（LMAX以下であること）
+            \param m 磁気量子数
+            \param sine spherical_harmonic_iに相当するものを使うかどうか（falseならspherical_harmonic_r）
+        */
+        CartesianYlm(std::uint32_t l, std::int32_t m, bool sine);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~CartesianYlm() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            単位ベクトル(x, y, z)の方向での球面調和関数の値を返す
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return 球面調和関数の値
+        */
+        double operator()(double x, double y, double z) const
+        {
+            return coef_ * func_(x, y, z);
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A public static member variable (constant).
+        /*!
+            特殊化された関数を持つlの最大値（GetDataが扱うs～gまで）
+        */
+        static std::uint32_t const LMAX = 4;
+
+    private:
+        //! A private member variable.
+        /*!
+            正規化定数と符号
+        */
+        double coef_;
+
+        //! A private member variable.
+        /*!
+            (l, |m|, sine)に特殊化された関数
+        */
+        function_type func_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        CartesianYlm() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        CartesianYlm(CartesianYlm const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        CartesianYlm & operator=(CartesianYlm const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _CARTESIANYLM_H_
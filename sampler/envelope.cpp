@@ -0,0 +1,35 @@
+﻿/*! \file envelope.cpp
+    \brief 棄却法の包絡線（目的の分布の上限）を求める関数の実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "envelope.h"
+#include <algorithm>                                            // for std::max
+#include <cmath>                                                // for std::fabs
+#include <cstdlib>                                              // for std::abs
+#include <boost/math/constants/constants.hpp>                   // for boost::math::constants::pi
+#include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic_r
+
+namespace sampler {
+    double YlmAbsMax(std::uint32_t l, std::int32_t m, bool sine)
+    {
+        // sin(0φ)は恒等的に0
+        if (sine && !m) {
+            return 0.0;
+        }
+
+        // φ部分の絶対値の最大値は1なので、θについてだけ最大値を探せばよい
+        static auto const NTHETA = 4096;
+        auto const dtheta = boost::math::constants::pi<double>() / static_cast<double>(NTHETA);
+        auto absmax = 0.0;
+        for (auto i = 0; i <= NTHETA; i++) {
+            auto const theta = dtheta * static_cast<double>(i);
+            absmax = std::max(absmax, std::fabs(boost::math::spherical_harmonic_r(l, std::abs(m), theta, 0.0)));
+        }
+
+        return absmax;
+    }
+}
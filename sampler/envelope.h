@@ -0,0 +1,34 @@
+﻿/*! \file envelope.h
+    \brief 棄却法の包絡線（目的の分布の上限）を求める関数の宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _ENVELOPE_H_
+#define _ENVELOPE_H_
+
+#pragma once
+
+#include <cstdint>  // for std::int32_t, std::uint32_t
+
+namespace sampler {
+    //! A global variable (constant).
+    /*!
+        包絡線にかける安全係数
+        メッシュ点の間でのスプラインの行き過ぎと、角度の格子の粗さを吸収する
+    */
+    static auto const ENVELOPE_MARGIN = 1.02;
+
+    //! A function.
+    /*!
+        実数の球面調和関数 N P_l^|m|(cosθ) cos(|m|φ)（またはsin(|m|φ)）の絶対値の最大値を求める
+        \param l 方位量子数
+        \param m 磁気量子数（符号は無視される）
+        \param sine φ部分がsin(|m|φ)ならtrue、cos(|m|φ)ならfalse
+        \return 絶対値の最大値
+    */
+    double YlmAbsMax(std::uint32_t l, std::int32_t m, bool sine);
+}
+
+#endif  // _ENVELOPE_H_
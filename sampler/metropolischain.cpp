@@ -0,0 +1,142 @@
+﻿/*! \file metropolischain.cpp
+    \brief メトロポリス・ヘイスティングス法のマルコフ連鎖を表すクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "metropolischain.h"
+#include <cmath>    // for std::exp, std::fabs, std::sqrt
+
+namespace sampler {
+    double const MetropolisChain::TARGET_ACCEPTANCE = 0.5;
+
+    // #region コンストラクタ
+
+    MetropolisChain::MetropolisChain(density_type const & density, double halfwidth, std::int32_t burnin, std::int32_t thin) :
+        burnin_(burnin),
+        density_(density),
+        halfwidth_(halfwidth),
+        step_(0.1 * halfwidth),
+        thin_(thin)
+    {
+        history_.reserve(HISTORY_MAX);
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    double MetropolisChain::operator()(myrandom::Xoshiro256 & rs, double & x, double & y, double & z)
+    {
+        if (!initialized_) {
+            BurnIn(rs);
+        }
+
+        for (auto i = 0; i < thin_; i++) {
+            trials_++;
+            if (Advance(rs)) {
+                accepted_++;
+            }
+        }
+
+        x = x_;
+        y = y_;
+        z = z_;
+
+        if (history_.size() < static_cast<std::size_t>(HISTORY_MAX)) {
+            history_.push_back(std::sqrt(x_ * x_ + y_ * y_ + z_ * z_));
+        }
+
+        return p_;
+    }
+
+    double MetropolisChain::AutocorrTime() const
+    {
+        auto const n = static_cast<std::int32_t>(history_.size());
+        if (n < 2) {
+            return 1.0;
+        }
+
+        auto mean = 0.0;
+        for (auto const r : history_) {
+            mean += r;
+        }
+        mean /= static_cast<double>(n);
+
+        auto c0 = 0.0;
+        for (auto const r : history_) {
+            c0 += (r - mean) * (r - mean);
+        }
+
+        if (c0 <= 0.0) {
+            return 1.0;
+        }
+
+        // 窓の幅が自己相関時間の5倍を超えたところで和を打ち切る
+        auto tau = 1.0;
+        for (auto t = 1; t < n; t++) {
+            auto ct = 0.0;
+            for (auto i = 0; i < n - t; i++) {
+                ct += (history_[i] - mean) * (history_[i + t] - mean);
+            }
+
+            tau += 2.0 * ct / c0;
+            if (static_cast<double>(t) >= 5.0 * tau) {
+                break;
+            }
+        }
+
+        return tau > 1.0 ? tau : 1.0;
+    }
+
+    bool MetropolisChain::Advance(myrandom::Xoshiro256 & rs)
+    {
+        auto const x = x_ + rs.myrand(-step_, step_);
+        auto const y = y_ + rs.myrand(-step_, step_);
+        auto const z = z_ + rs.myrand(-step_, step_);
+        auto const p = density_(x, y, z);
+
+        // 提案分布は対称なので、目的の分布の比だけで採否を決める
+        if (std::fabs(p) >= rs.myrand() * std::fabs(p_)) {
+            x_ = x;
+            y_ = y;
+            z_ = z;
+            p_ = p;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    void MetropolisChain::BurnIn(myrandom::Xoshiro256 & rs)
+    {
+        // 目的の分布が0でない点から始める
+        do {
+            x_ = rs.myrand(-halfwidth_, halfwidth_);
+            y_ = rs.myrand(-halfwidth_, halfwidth_);
+            z_ = rs.myrand(-halfwidth_, halfwidth_);
+            p_ = density_(x_, y_, z_);
+        } while (p_ == 0.0);
+
+        // 一定間隔ごとの採択率が目標値に近づくようにステップ幅を伸縮させる
+        auto accepted = 0;
+        for (auto i = 1; i <= burnin_; i++) {
+            if (Advance(rs)) {
+                accepted++;
+            }
+
+            if (i % ADAPT_INTERVAL == 0) {
+                auto const rate = static_cast<double>(accepted) / static_cast<double>(ADAPT_INTERVAL);
+                step_ *= std::exp(rate - TARGET_ACCEPTANCE);
+                accepted = 0;
+            }
+        }
+
+        initialized_ = true;
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,235 @@
+﻿/*! \file metropolischain.h
+    \brief メトロポリス・ヘイスティングス法のマルコフ連鎖を表すクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _METROPOLISCHAIN_H_
+#define _METROPOLISCHAIN_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cstdint>      // for std::int32_t, std::uint64_t
+#include <functional>   // for std::function
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        ランダムウォーク型のメトロポリス・ヘイスティングス法で、目的の分布に従う点を生成するクラス
+        TBBのワーカースレッドごとに一つずつ持つことを想定している
+        ステップ幅は、バーンインの間だけ採択率が目標値に近づくように調節する
+    */
+    class MetropolisChain final {
+        // #region 型エイリアス
+
+    public:
+        using density_type = std::function<double(double, double, double)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param density 目的の分布（波動関数の場合は符号付きの値を返してよい）
+            \param halfwidth 初期位置を選ぶ立方体の一辺の長さの半分
+            \param burnin バーンインで捨てるステップ数
+            \param thin 出力する点の間に進めるステップ数
+        */
+        MetropolisChain(density_type const & density, double halfwidth, std::int32_t burnin, std::int32_t thin);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~MetropolisChain() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function.
+        /*!
+            連鎖を進めて、次の点を生成する（最初の呼び出しではバーンインを行う）
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param x 生成された点のx座標
+            \param y 生成された点のy座標
+            \param z 生成された点のz座標
+            \return 生成された点での目的の分布の値
+        */
+        double operator()(myrandom::Xoshiro256 & rs, double & x, double & y, double & z);
+
+        //!  A public member function (const).
+        /*!
+            バーンイン後の提案が採択された回数を返す
+            \return 採択された回数
+        */
+        std::uint64_t Accepted() const
+        {
+            return accepted_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            出力した点の動径の列から、積分自己相関時間を求める（Sokalの自動窓）
+            \return 積分自己相関時間（出力した点の個数を単位とする、独立なら1）
+        */
+        double AutocorrTime() const;
+
+        //!  A public member function (const).
+        /*!
+            調節後のステップ幅を返す
+            \return ステップ幅
+        */
+        double Step() const
+        {
+            return step_;
+        }
+
+        //!  A public member function (const).
+        /*!
+            バーンイン後の提案の回数を返す
+            \return 提案の回数
+        */
+        std::uint64_t Trials() const
+        {
+            return trials_;
+        }
+
+    private:
+        //!  A private member function.
+        /*!
+            連鎖を一歩進める
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 提案が採択されたかどうか
+        */
+        bool Advance(myrandom::Xoshiro256 & rs);
+
+        //!  A private member function.
+        /*!
+            初期位置を選び、ステップ幅を調節しながらバーンインを行う
+            \param rs 呼び出したスレッドの乱数エンジン
+        */
+        void BurnIn(myrandom::Xoshiro256 & rs);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    public:
+        //! A public static member variable (constant).
+        /*!
+            ステップ幅を調節する間隔（ステップ数）
+        */
+        static std::int32_t const ADAPT_INTERVAL = 100;
+
+        //! A public static member variable (constant).
+        /*!
+            自己相関時間の計算に使う点の最大数
+        */
+        static std::int32_t const HISTORY_MAX = 4096;
+
+        //! A public static member variable (constant).
+        /*!
+            ステップ幅を調節するときの目標の採択率
+        */
+        static double const TARGET_ACCEPTANCE;
+
+    private:
+        //! A private member variable.
+        /*!
+            バーンイン後の採択回数
+        */
+        std::uint64_t accepted_ = 0;
+
+        //! A private member variable.
+        /*!
+            バーンインで捨てるステップ数
+        */
+        std::int32_t burnin_;
+
+        //! A private member variable.
+        /*!
+            目的の分布
+        */
+        density_type density_;
+
+        //! A private member variable.
+        /*!
+            初期位置を選ぶ立方体の一辺の長さの半分
+        */
+        double halfwidth_;
+
+        //! A private member variable.
+        /*!
+            出力した点の動径の列
+        */
+        std::vector<double> history_;
+
+        //! A private member variable.
+        /*!
+            バーンインが済んだかどうか
+        */
+        bool initialized_ = false;
+
+        //! A private member variable.
+        /*!
+            現在の点での目的の分布の値
+        */
+        double p_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            ステップ幅
+        */
+        double step_;
+
+        //! A private member variable.
+        /*!
+            出力する点の間に進めるステップ数
+        */
+        std::int32_t thin_;
+
+        //! A private member variable.
+        /*!
+            バーンイン後の提案の回数
+        */
+        std::uint64_t trials_ = 0;
+
+        //! A private member variable.
+        /*!
+            現在の点のx座標
+        */
+        double x_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            現在の点のy座標
+        */
+        double y_ = 0.0;
+
+        //! A private member variable.
+        /*!
+            現在の点のz座標
+        */
+        double z_ = 0.0;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        MetropolisChain() = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _METROPOLISCHAIN_H_
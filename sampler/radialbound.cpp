@@ -0,0 +1,31 @@
+﻿/*! \file radialbound.cpp
+    \brief 動径部分の絶対値の上限を区間ごとの表で与えるクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "radialbound.h"
+#include "envelope.h"
+
+namespace sampler {
+    // #region コンストラクタ
+
+    RadialBound::RadialBound(getdata::GetData const & gd, double rmax, std::size_t nbin) :
+        invdr_(static_cast<double>(nbin) / (rmax - gd.R_meshmin())),
+        max_(nbin),
+        rmin_(gd.R_meshmin())
+    {
+        auto const dr = (rmax - rmin_) / static_cast<double>(nbin);
+
+        for (auto i = 0U; i < nbin; i++) {
+            auto const r0 = rmin_ + dr * static_cast<double>(i);
+
+            // メッシュ点の間でのスプラインの行き過ぎは、安全係数で吸収する
+            max_[i] = gd.AbsMax(r0, r0 + dr) * ENVELOPE_MARGIN;
+        }
+    }
+
+    // #endregion コンストラクタ
+}
@@ -0,0 +1,110 @@
+﻿/*! \file radialbound.h
+    \brief 動径部分の絶対値の上限を区間ごとの表で与えるクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RADIALBOUND_H_
+#define _RADIALBOUND_H_
+
+#pragma once
+
+#include "../getdata/getdata.h"
+#include <algorithm>    // for std::min
+#include <cstddef>      // for std::size_t
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        [R_meshmin, rmax]を等間隔の区間に分割し、区間ごとの動径部分の絶対値の上限を保持するクラス
+        棄却法の前段で、スプラインを評価せずに候補を棄却するために使う
+    */
+    class RadialBound final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param gd データオブジェクト
+            \param rmax 描画するrの最大値
+            \param nbin 区間の数
+        */
+        RadialBound(getdata::GetData const & gd, double rmax, std::size_t nbin);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RadialBound() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            rを含む区間での動径部分の絶対値の上限を返す
+            \param r 候補のrの値（R_meshmin ≦ r ≦ rmax）
+            \return 動径部分の絶対値の上限
+        */
+        double operator()(double r) const
+        {
+            auto const i = static_cast<std::size_t>((r - rmin_) * invdr_);
+            return max_[std::min(i, max_.size() - 1)];
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            区間の幅の逆数
+        */
+        double invdr_;
+
+        //! A private member variable.
+        /*!
+            区間ごとの動径部分の絶対値の上限（安全係数込み）
+        */
+        std::vector<double> max_;
+
+        //! A private member variable.
+        /*!
+            最初の区間の左端
+        */
+        double rmin_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        RadialBound() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        RadialBound(RadialBound const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        RadialBound & operator=(RadialBound const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _RADIALBOUND_H_
@@ -0,0 +1,50 @@
+﻿/*! \file radialshells.cpp
+    \brief 動径方向の殻ごとの包絡線で棄却法を行うためのクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "radialshells.h"
+#include <cmath>    // for std::cbrt
+
+namespace sampler {
+    // #region コンストラクタ
+
+    RadialShells::RadialShells(getdata::GetData const & gd, double rmax, double angularmax, std::size_t nshell) :
+        edge3_(nshell + 1),
+        max_(nshell)
+    {
+        auto const rmin = gd.R_meshmin();
+        auto const dr = (rmax - rmin) / static_cast<double>(nshell);
+
+        std::vector<double> mass(nshell);
+        for (auto i = 0U; i <= nshell; i++) {
+            auto const r = rmin + dr * static_cast<double>(i);
+            edge3_[i] = r * r * r;
+        }
+
+        for (auto i = 0U; i < nshell; i++) {
+            auto const r0 = rmin + dr * static_cast<double>(i);
+
+            // 殻の中での目的の分布の上限と、包絡線の質量（体積の4π/3は共通なので省く）
+            max_[i] = gd.AbsMax(r0, r0 + dr) * angularmax;
+            mass[i] = max_[i] * (edge3_[i + 1] - edge3_[i]);
+        }
+
+        palias_.reset(new AliasTable(mass));
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    double RadialShells::SampleR(myrandom::Xoshiro256 & rs, std::size_t i) const
+    {
+        // r^3について一様に取れば、殻の体積について一様になる
+        return std::cbrt(edge3_[i] + rs.myrand() * (edge3_[i + 1] - edge3_[i]));
+    }
+
+    // #endregion メンバ関数
+}
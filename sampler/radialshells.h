@@ -0,0 +1,131 @@
+﻿/*! \file radialshells.h
+    \brief 動径方向の殻ごとの包絡線で棄却法を行うためのクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _RADIALSHELLS_H_
+#define _RADIALSHELLS_H_
+
+#pragma once
+
+#include "aliastable.h"
+#include "../getdata/getdata.h"
+#include <cstddef>  // for std::size_t
+#include <memory>   // for std::unique_ptr
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        [R_meshmin, rmax]を殻に分割し、殻ごとの目的の分布の最大値を包絡線とするクラス
+        殻は包絡線の質量（最大値×体積）に比例した確率でエイリアス法により選ばれる
+    */
+    class RadialShells final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param gd データオブジェクト
+            \param rmax 描画するrの最大値
+            \param angularmax 角度部分の上限（安全係数込み）
+            \param nshell 殻の数
+        */
+        RadialShells(getdata::GetData const & gd, double rmax, double angularmax, std::size_t nshell);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~RadialShells() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            包絡線の質量に比例した確率で殻を一つ選ぶ
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 選ばれた殻の添字
+        */
+        std::size_t operator()(myrandom::Xoshiro256 & rs) const
+        {
+            return (*palias_)(rs);
+        }
+
+        //!  A public member function (const).
+        /*!
+            殻の中での目的の分布の上限を返す
+            \param i 殻の添字
+            \return 目的の分布の上限
+        */
+        double Max(std::size_t i) const
+        {
+            return max_[i];
+        }
+
+        //!  A public member function (const).
+        /*!
+            殻の中で体積について一様にrを生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param i 殻の添字
+            \return 生成されたrの値
+        */
+        double SampleR(myrandom::Xoshiro256 & rs, std::size_t i) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            殻の境界の3乗
+        */
+        std::vector<double> edge3_;
+
+        //! A private member variable.
+        /*!
+            殻ごとの目的の分布の上限
+        */
+        std::vector<double> max_;
+
+        //! A private member variable.
+        /*!
+            殻を選ぶエイリアス表
+        */
+        std::unique_ptr<AliasTable> palias_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        RadialShells() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        RadialShells(RadialShells const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        RadialShells & operator=(RadialShells const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _RADIALSHELLS_H_
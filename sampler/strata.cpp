@@ -0,0 +1,98 @@
+﻿/*! \file strata.cpp
+    \brief 確率の質量が等しい動径方向の殻と角度方向のセルで層別化するクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "strata.h"
+#include "envelope.h"
+#include <algorithm>                        // for std::max, std::min
+#include <cmath>                            // for std::floor
+#include <numeric>                          // for std::accumulate
+#include <stdexcept>                        // for std::invalid_argument
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace sampler {
+    // #region コンストラクタ
+
+    Strata::Strata(function_type const & angular, std::size_t nshell, std::size_t ntheta, std::size_t nphi, std::size_t n) :
+        max_(ntheta * nphi),
+        nshell_(nshell),
+        nphi_(nphi),
+        ntheta_(ntheta),
+        offset_(nshell * ntheta * nphi + 1, 0)
+    {
+        // セルごとの質量と上限は、セルを細かく分けた格子点での値から台形公式で見積もる
+        static auto const NSUB = 8U;
+
+        auto const ncell = ntheta * nphi;
+        auto const dcostheta = 2.0 / static_cast<double>(ntheta * NSUB);
+        auto const dphi = 2.0 * boost::math::constants::pi<double>() / static_cast<double>(nphi * NSUB);
+
+        std::vector<double> mass(ncell, 0.0);
+        for (auto c = 0U; c < ncell; c++) {
+            auto const it = c / nphi;
+            auto const ip = c % nphi;
+
+            auto cellmax = 0.0;
+            for (auto i = 0U; i <= NSUB; i++) {
+                auto const costheta = -1.0 + dcostheta * static_cast<double>(it * NSUB + i);
+                auto const wi = i == 0 || i == NSUB ? 0.5 : 1.0;
+
+                for (auto j = 0U; j <= NSUB; j++) {
+                    auto const v = angular(costheta, dphi * static_cast<double>(ip * NSUB + j));
+                    auto const wj = j == 0 || j == NSUB ? 0.5 : 1.0;
+
+                    mass[c] += wi * wj * v;
+                    cellmax = std::max(cellmax, v);
+                }
+            }
+
+            max_[c] = cellmax * ENVELOPE_MARGIN;
+        }
+
+        auto const total = std::accumulate(mass.begin(), mass.end(), 0.0);
+        if (total <= 0.0) {
+            throw std::invalid_argument("重みの総和が0です！");
+        }
+
+        // 殻はどれも質量が1 / nshellなので、層の質量はセルの質量に比例する
+        // 累積の質量をn倍して丸めた値を境界にすれば、点の数の合計はちょうどnになり、端数も層の間で偏らない
+        auto const nstrata = nshell * ncell;
+        auto cumulative = 0.0;
+        for (auto s = 0U; s < nstrata; s++) {
+            cumulative += mass[s % ncell] / (total * static_cast<double>(nshell));
+            offset_[s + 1] = std::min(n, static_cast<std::size_t>(std::floor(static_cast<double>(n) * cumulative + 0.5)));
+        }
+        offset_[nstrata] = n;
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    double Strata::Quantile(std::size_t s, std::size_t i, double u) const
+    {
+        // 殻の中をさらに層の点の数で等分し、i番目の点はその小区間から取る
+        auto const shell = s / max_.size();
+        auto const count = static_cast<double>(Last(s) - First(s));
+        auto const t = (static_cast<double>(i - First(s)) + u) / count;
+
+        return (static_cast<double>(shell) + t) / static_cast<double>(nshell_);
+    }
+
+    void Strata::SampleAngles(myrandom::Xoshiro256 & rs, std::size_t s, double & costheta, double & phi) const
+    {
+        auto const c = s % max_.size();
+        auto const dcostheta = 2.0 / static_cast<double>(ntheta_);
+        auto const dphi = 2.0 * boost::math::constants::pi<double>() / static_cast<double>(nphi_);
+
+        // cosθについて一様に取れば、セルの立体角について一様になる
+        costheta = -1.0 + dcostheta * (static_cast<double>(c / nphi_) + rs.myrand());
+        phi = dphi * (static_cast<double>(c % nphi_) + rs.myrand());
+    }
+
+    // #endregion メンバ関数
+}
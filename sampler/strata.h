@@ -0,0 +1,182 @@
+﻿/*! \file strata.h
+    \brief 確率の質量が等しい動径方向の殻と角度方向のセルで層別化するクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _STRATA_H_
+#define _STRATA_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cstddef>      // for std::size_t
+#include <functional>   // for std::function
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        動径分布を質量の等しいnshell個の殻に、球面を(cosθ, φ)の等間隔なntheta×nphi個のセルに分け、
+        その直積を層として、層ごとの質量に比例した点の数（合計がちょうどn）を割り当てるクラス
+        層s = 殻の添字×セルの数＋セルの添字の点は、頂点の添字[First(s), Last(s))に詰める
+    */
+    class Strata final {
+        // #region 型エイリアス
+
+    public:
+        using function_type = std::function<double(double, double)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param angular 角度部分の分布（引数はcosθとφ、非負で、球面上での積分が正であること）
+            \param nshell 動径方向の殻の数
+            \param ntheta cosθ方向のセルの数
+            \param nphi φ方向のセルの数
+            \param n 生成する点の総数
+        */
+        Strata(function_type const & angular, std::size_t nshell, std::size_t ntheta, std::size_t nphi, std::size_t n);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Strata() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            層の最初の点の頂点の添字を返す
+            \param s 層の添字
+            \return 最初の点の頂点の添字
+        */
+        std::size_t First(std::size_t s) const
+        {
+            return offset_[s];
+        }
+
+        //!  A public member function (const).
+        /*!
+            層の最後の点の次の頂点の添字を返す
+            \param s 層の添字
+            \return 最後の点の次の頂点の添字
+        */
+        std::size_t Last(std::size_t s) const
+        {
+            return offset_[s + 1];
+        }
+
+        //!  A public member function (const).
+        /*!
+            層のセルの中での角度部分の分布の上限を返す
+            \param s 層の添字
+            \return 角度部分の分布の上限（安全係数込み）
+        */
+        double Max(std::size_t s) const
+        {
+            return max_[s % max_.size()];
+        }
+
+        //!  A public member function (const).
+        /*!
+            層の中の点に、殻の中でさらに層別化した動径分布の累積分布関数の値を与える
+            \param s 層の添字
+            \param i 点の頂点の添字（First(s) ≦ i < Last(s)）
+            \param u [0, 1)の一様乱数
+            \return 累積分布関数の値（[0, 1]に規格化されたもの）
+        */
+        double Quantile(std::size_t s, std::size_t i, double u) const;
+
+        //!  A public member function (const).
+        /*!
+            層のセルの中で、立体角について一様に(cosθ, φ)を生成する
+            \param rs 乱数エンジン
+            \param s 層の添字
+            \param costheta 生成されたcosθ
+            \param phi 生成されたφ
+        */
+        void SampleAngles(myrandom::Xoshiro256 & rs, std::size_t s, double & costheta, double & phi) const;
+
+        //!  A public member function (const).
+        /*!
+            層の数を返す
+            \return 層の数
+        */
+        std::size_t size() const
+        {
+            return offset_.size() - 1;
+        }
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            セルごとの角度部分の分布の上限（安全係数込み）
+        */
+        std::vector<double> max_;
+
+        //! A private member variable.
+        /*!
+            動径方向の殻の数
+        */
+        std::size_t nshell_;
+
+        //! A private member variable.
+        /*!
+            φ方向のセルの数
+        */
+        std::size_t nphi_;
+
+        //! A private member variable.
+        /*!
+            cosθ方向のセルの数
+        */
+        std::size_t ntheta_;
+
+        //! A private member variable.
+        /*!
+            層ごとの最初の点の頂点の添字（末尾は点の総数）
+        */
+        std::vector<std::size_t> offset_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Strata() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        Strata(Strata const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        Strata & operator=(Strata const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _STRATA_H_
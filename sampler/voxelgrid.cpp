@@ -0,0 +1,64 @@
+﻿/*! \file voxelgrid.cpp
+    \brief 3次元のボクセル格子で重点サンプリングを行うクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "voxelgrid.h"
+#include <cmath>                    // for std::sqrt
+#include <tbb/parallel_for.h>       // for tbb::parallel_for
+
+namespace sampler {
+    // #region コンストラクタ
+
+    VoxelGrid::VoxelGrid(bound_type const & bound, double halfwidth, std::int32_t n) :
+        halfwidth_(halfwidth),
+        max_(static_cast<std::size_t>(n) * n * n),
+        n_(n),
+        width_(2.0 * halfwidth / static_cast<double>(n))
+    {
+        // ボクセルは、中心から頂点までの距離を半径とする球に含まれる
+        auto const radius = 0.5 * std::sqrt(3.0) * width_;
+
+        // ボクセルを含む球の中での上限を、そのボクセルの上限とする（z方向の面ごとに並列化）
+        tbb::parallel_for(
+            0,
+            n,
+            [&](std::int32_t kz) {
+                auto const z = -halfwidth + width_ * (static_cast<double>(kz) + 0.5);
+                for (auto ky = 0; ky < n; ky++) {
+                    auto const y = -halfwidth + width_ * (static_cast<double>(ky) + 0.5);
+                    for (auto kx = 0; kx < n; kx++) {
+                        auto const x = -halfwidth + width_ * (static_cast<double>(kx) + 0.5);
+
+                        // 半径halfwidthの球と交わらないボクセルは選ばない
+                        auto const d = std::sqrt(x * x + y * y + z * z);
+                        max_[(static_cast<std::size_t>(kz) * n + ky) * n + kx] = d - radius < halfwidth ? bound(x, y, z, radius) : 0.0;
+                    }
+                }
+            });
+
+        // ボクセルの体積はすべて等しいので、上限をそのまま重みにする
+        palias_.reset(new AliasTable(max_));
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void VoxelGrid::SamplePoint(myrandom::Xoshiro256 & rs, std::size_t i, double & x, double & y, double & z) const
+    {
+        auto const n = static_cast<std::size_t>(n_);
+        auto const kx = i % n;
+        auto const ky = (i / n) % n;
+        auto const kz = i / (n * n);
+
+        x = -halfwidth_ + width_ * (static_cast<double>(kx) + rs.myrand());
+        y = -halfwidth_ + width_ * (static_cast<double>(ky) + rs.myrand());
+        z = -halfwidth_ + width_ * (static_cast<double>(kz) + rs.myrand());
+    }
+
+    // #endregion メンバ関数
+}
@@ -0,0 +1,152 @@
+﻿/*! \file voxelgrid.h
+    \brief 3次元のボクセル格子で重点サンプリングを行うクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _VOXELGRID_H_
+#define _VOXELGRID_H_
+
+#pragma once
+
+#include "aliastable.h"
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t
+#include <functional>   // for std::function
+#include <memory>       // for std::unique_ptr
+#include <vector>       // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        立方体[-halfwidth, halfwidth]^3をボクセルに分割し、半径halfwidthの球と交わるボクセルごとに目的の分布の上限を表にするクラス
+        ボクセルは上限に比例した確率でエイリアス法により選ばれ、その中で棄却法を行う（球の外側に出た点は呼び出し側で棄却する）
+        上限は「球の中での上限」を返す関数オブジェクトとして与えるので、軌道ごとの解析的な計算は必要ない
+    */
+    class VoxelGrid final {
+        // #region 型エイリアス
+
+    public:
+        using bound_type = std::function<double(double, double, double, double)>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ（ボクセルごとの上限はTBBで並列に求める）
+            \param bound 中心(x, y, z)、半径ρの球の中での目的の分布の絶対値の上限を返す関数オブジェクト（引数は順にx, y, z, ρ）
+            \param halfwidth 立方体の一辺の長さの半分（点を生成する球の半径）
+            \param n 一辺あたりのボクセルの数
+        */
+        VoxelGrid(bound_type const & bound, double halfwidth, std::int32_t n);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~VoxelGrid() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            上限に比例した確率でボクセルを一つ選ぶ
+            \param rs 呼び出したスレッドの乱数エンジン
+            \return 選ばれたボクセルの添字
+        */
+        std::size_t operator()(myrandom::Xoshiro256 & rs) const
+        {
+            return (*palias_)(rs);
+        }
+
+        //!  A public member function (const).
+        /*!
+            ボクセルの中での目的の分布の上限を返す
+            \param i ボクセルの添字
+            \return 目的の分布の上限
+        */
+        double Max(std::size_t i) const
+        {
+            return max_[i];
+        }
+
+        //!  A public member function (const).
+        /*!
+            ボクセルの中で一様に点を生成する
+            \param rs 呼び出したスレッドの乱数エンジン
+            \param i ボクセルの添字
+            \param x 生成された点のx座標
+            \param y 生成された点のy座標
+            \param z 生成された点のz座標
+        */
+        void SamplePoint(myrandom::Xoshiro256 & rs, std::size_t i, double & x, double & y, double & z) const;
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            一辺の長さの半分
+        */
+        double halfwidth_;
+
+        //! A private member variable.
+        /*!
+            ボクセルごとの目的の分布の上限
+        */
+        std::vector<double> max_;
+
+        //! A private member variable.
+        /*!
+            一辺あたりのボクセルの数
+        */
+        std::int32_t n_;
+
+        //! A private member variable.
+        /*!
+            ボクセルを選ぶエイリアス表
+        */
+        std::unique_ptr<AliasTable> palias_;
+
+        //! A private member variable.
+        /*!
+            ボクセルの一辺の長さ
+        */
+        double width_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        VoxelGrid() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        VoxelGrid(VoxelGrid const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        VoxelGrid & operator=(VoxelGrid const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _VOXELGRID_H_
@@ -0,0 +1,37 @@
+﻿/*! \file weightedsample.cpp
+    \brief 重み付きの点の集合の統計量と、重みのない点への再サンプリングを行う関数の実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "weightedsample.h"
+#include <numeric>      // for std::accumulate
+#include <stdexcept>    // for std::invalid_argument
+
+namespace sampler {
+    void Resample(myrandom::Xoshiro256 & rs, std::vector<double> const & weights, std::vector<std::size_t> & indices)
+    {
+        auto const total = std::accumulate(weights.begin(), weights.end(), 0.0);
+        if (weights.empty() || total <= 0.0) {
+            throw std::invalid_argument("重みの総和が0です！");
+        }
+
+        // 累積重みの上を、一つの乱数から始めた等間隔の点で走査する
+        auto const n = indices.size();
+        auto const step = total / static_cast<double>(n);
+        auto u = rs.myrand() * step;
+        auto cumulative = weights[0];
+        auto j = 0U;
+
+        for (auto i = 0U; i < n; i++) {
+            while (u >= cumulative && j + 1 < weights.size()) {
+                cumulative += weights[++j];
+            }
+
+            indices[i] = j;
+            u += step;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+﻿/*! \file weightedsample.h
+    \brief 重み付きの点の集合の統計量と、重みのない点への再サンプリングを行う関数の宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _WEIGHTEDSAMPLE_H_
+#define _WEIGHTEDSAMPLE_H_
+
+#pragma once
+
+#include "../myrandom/xoshiro256.h"
+#include <cmath>    // for std::sqrt
+#include <cstddef>  // for std::size_t
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A struct.
+    /*!
+        重み付きの点の集合の統計量
+    */
+    struct WeightedMoments {
+        //! A public member variable.
+        /*!
+            有効サンプル数（(Σw)^2 / Σw^2）
+        */
+        double Ess;
+
+        //! A public member variable.
+        /*!
+            重み付きの<r>
+        */
+        double MeanR;
+
+        //! A public member variable.
+        /*!
+            重み付きの<r^2>
+        */
+        double MeanR2;
+
+        //! A public member variable.
+        /*!
+            重み付きの<x^2>
+        */
+        double MeanX2;
+
+        //! A public member variable.
+        /*!
+            重み付きの<y^2>
+        */
+        double MeanY2;
+
+        //! A public member variable.
+        /*!
+            重み付きの<z^2>
+        */
+        double MeanZ2;
+    };
+
+    //! A function.
+    /*!
+        重み付きの点の集合の統計量を求める（重みがすべて0の場合は、統計量もすべて0とする）
+        \param vertices 点の配列（各要素はPos.x, Pos.y, Pos.zを持つ）
+        \param weights 点の重みの配列（verticesと同じ長さ）
+        \return 統計量
+    */
+    template <typename Vertex>
+    WeightedMoments GetWeightedMoments(std::vector<Vertex> const & vertices, std::vector<double> const & weights)
+    {
+        WeightedMoments mom = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        auto sumw = 0.0, sumw2 = 0.0;
+
+        for (auto i = 0U; i < vertices.size(); i++) {
+            auto const w = weights[i];
+            auto const x = static_cast<double>(vertices[i].Pos.x);
+            auto const y = static_cast<double>(vertices[i].Pos.y);
+            auto const z = static_cast<double>(vertices[i].Pos.z);
+            auto const r2 = x * x + y * y + z * z;
+
+            sumw += w;
+            sumw2 += w * w;
+            mom.MeanR += w * std::sqrt(r2);
+            mom.MeanR2 += w * r2;
+            mom.MeanX2 += w * x * x;
+            mom.MeanY2 += w * y * y;
+            mom.MeanZ2 += w * z * z;
+        }
+
+        if (sumw <= 0.0) {
+            return WeightedMoments { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        }
+
+        mom.Ess = sumw * sumw / sumw2;
+        mom.MeanR /= sumw;
+        mom.MeanR2 /= sumw;
+        mom.MeanX2 /= sumw;
+        mom.MeanY2 /= sumw;
+        mom.MeanZ2 /= sumw;
+
+        return mom;
+    }
+
+    //! A function.
+    /*!
+        重み付きの点の集合から、重みに比例した確率で添字を選び直す（系統的再サンプリング、O(n)）
+        選ばれた添字の点は、重みのない（重みがすべて等しい）点の集合として扱える
+        \param rs 乱数エンジン
+        \param weights 点の重みの配列（負でない、総和が正）
+        \param indices 選ばれた添字の出力先（要素数が選ぶ点の数）
+    */
+    void Resample(myrandom::Xoshiro256 & rs, std::vector<double> const & weights, std::vector<std::size_t> & indices);
+}
+
+#endif  // _WEIGHTEDSAMPLE_H_
@@ -0,0 +1,131 @@
+﻿/*! \file ylmladder.cpp
+    \brief 一つの方向について、すべてのmの球面調和関数を一度に求めるクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "ylmladder.h"
+#include <cmath>                                // for std::sqrt
+#include <cstdlib>                              // for std::abs
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace sampler {
+    // #region コンストラクタ
+
+    YlmLadder::YlmLadder(std::uint32_t l) :
+        a_((l + 1) * (l + 1), 0.0),
+        b_((l + 1) * (l + 1), 0.0),
+        l_(l),
+        pmm_(l + 1)
+    {
+        // P_m^m = (-1)^m sqrt((2m + 1) / 4π × Π_{k=1}^{m} (2k - 1) / 2k) sin^mθ
+        auto prod = 1.0;
+        for (auto m = 0U; m <= l; m++) {
+            if (m) {
+                prod *= static_cast<double>(2 * m - 1) / static_cast<double>(2 * m);
+            }
+
+            pmm_[m] = std::sqrt(static_cast<double>(2 * m + 1) / (4.0 * boost::math::constants::pi<double>()) * prod);
+            if (m & 1U) {
+                pmm_[m] = -pmm_[m];
+            }
+
+            // P_k^m = a (cosθ P_{k-1}^m - b P_{k-2}^m)
+            for (auto k = m + 1; k <= l; k++) {
+                auto const k2 = static_cast<double>(k * k);
+                auto const m2 = static_cast<double>(m * m);
+                auto const km1 = static_cast<double>((k - 1) * (k - 1));
+                a_[m * (l + 1) + k] = std::sqrt((4.0 * k2 - 1.0) / (k2 - m2));
+                b_[m * (l + 1) + k] = std::sqrt((km1 - m2) / (4.0 * km1 - 1.0));
+            }
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region メンバ関数
+
+    void YlmLadder::operator()(double x, double y, double z, double * re, double * im) const
+    {
+        auto const s = std::sqrt(x * x + y * y);
+
+        // cos(mφ)、sin(mφ)の梯子（極ではφ = 0とする）
+        auto const cphi = s > 0.0 ? x / s : 1.0;
+        auto const sphi = s > 0.0 ? y / s : 0.0;
+        auto cm = 1.0, sm = 0.0, smpow = 1.0;
+
+        for (auto m = 0U; m <= l_; m++) {
+            auto const p = Column(m, z, pmm_[m] * smpow);
+            re[m] = p * cm;
+            im[m] = p * sm;
+
+            auto const cn = cm * cphi - sm * sphi;
+            sm = sm * cphi + cm * sphi;
+            cm = cn;
+            smpow *= s;
+        }
+    }
+
+    double YlmLadder::Column(std::uint32_t m, double c, double pmm) const
+    {
+        if (m == l_) {
+            return pmm;
+        }
+
+        auto const * a = a_.data() + m * (l_ + 1);
+        auto const * b = b_.data() + m * (l_ + 1);
+
+        auto pm2 = pmm;
+        auto pm1 = a[m + 1] * c * pmm;
+        for (auto k = m + 2; k <= l_; k++) {
+            auto const p = a[k] * (c * pm1 - b[k] * pm2);
+            pm2 = pm1;
+            pm1 = p;
+        }
+
+        return pm1;
+    }
+
+    double YlmLadder::Component(double const * re, double const * im, std::int32_t m, bool sine)
+    {
+        auto const absm = std::abs(m);
+        return Sign(m, sine) * (sine ? im[absm] : re[absm]);
+    }
+
+    void YlmLadder::Evaluate(std::size_t n, double const * x, double const * y, double const * z, double * re, double * im) const
+    {
+        for (auto i = 0U; i < n; i++) {
+            (*this)(x[i], y[i], z[i], re + i * (l_ + 1), im + i * (l_ + 1));
+        }
+    }
+
+    double YlmLadder::Sign(std::int32_t m, bool sine)
+    {
+        // Y_l^{-|m|} = (-1)^|m| conj(Y_l^|m|)
+        if (m >= 0) {
+            return 1.0;
+        }
+
+        auto const sign = (std::abs(m) & 1) ? -1.0 : 1.0;
+        return sine ? -sign : sign;
+    }
+
+    double YlmLadder::Value(std::int32_t m, bool sine, double x, double y, double z) const
+    {
+        auto const absm = static_cast<std::uint32_t>(std::abs(m));
+
+        // (x + iy)^|m| = s^|m| (cos(|m|φ) + i sin(|m|φ))
+        auto re = 1.0, im = 0.0;
+        for (auto k = 0U; k < absm; k++) {
+            auto const rn = re * x - im * y;
+            im = re * y + im * x;
+            re = rn;
+        }
+
+        return Sign(m, sine) * Column(absm, z, pmm_[absm]) * (sine ? im : re);
+    }
+
+    // #endregion メンバ関数
+}
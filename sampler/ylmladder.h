@@ -0,0 +1,167 @@
+﻿/*! \file ylmladder.h
+    \brief 一つの方向について、すべてのmの球面調和関数を一度に求めるクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _YLMLADDER_H_
+#define _YLMLADDER_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+#include <vector>   // for std::vector
+
+namespace sampler {
+    //! A class.
+    /*!
+        正規化されたLegendre陪関数P_l^m（0 ≦ m ≦ l）とcos(mφ)、sin(mφ)の梯子を漸化式で一度に求めるクラス
+        漸化式の係数は構築時に一度だけ計算する
+        値はboost::math::spherical_harmonic_r、spherical_harmonic_iと同じ規約（Condon-Shortleyの位相を含む）に従う
+    */
+    class YlmLadder final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param l 方位量子数
+        */
+        explicit YlmLadder(std::uint32_t l);
+
+        //! A destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~YlmLadder() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            単位ベクトル(x, y, z)の方向で、m = 0, 1, ..., lのY_l^mの実部と虚部を求める
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \param re Y_l^mの実部の出力先（l + 1個）
+            \param im Y_l^mの虚部の出力先（l + 1個）
+        */
+        void operator()(double x, double y, double z, double * re, double * im) const;
+
+        //!  A public member function (const).
+        /*!
+            n個の方向について、m = 0, 1, ..., lのY_l^mの実部と虚部をまとめて求める
+            \param n 方向の数
+            \param x 単位ベクトルのx成分の配列
+            \param y 単位ベクトルのy成分の配列
+            \param z 単位ベクトルのz成分の配列
+            \param re Y_l^mの実部の出力先（i番目の方向のmは[i * (l + 1) + m]に入る）
+            \param im Y_l^mの虚部の出力先（並びはreと同じ）
+        */
+        void Evaluate(std::size_t n, double const * x, double const * y, double const * z, double * re, double * im) const;
+
+        //!  A public static member function.
+        /*!
+            すべてのmの値から、符号付きのmの実部または虚部を取り出す
+            \param re operator()で求めたY_l^mの実部
+            \param im operator()で求めたY_l^mの虚部
+            \param m 磁気量子数（負でもよい）
+            \param sine 虚部を取り出すかどうか（falseなら実部）
+            \return spherical_harmonic_r(l, m, θ, φ)またはspherical_harmonic_i(l, m, θ, φ)に等しい値
+        */
+        static double Component(double const * re, double const * im, std::int32_t m, bool sine);
+
+        //!  A public member function (const).
+        /*!
+            一つのmだけが必要な場合に、そのmの列の漸化式だけを計算する
+            \param m 磁気量子数（負でもよい）
+            \param sine 虚部を求めるかどうか（falseなら実部）
+            \param x 単位ベクトルのx成分
+            \param y 単位ベクトルのy成分
+            \param z 単位ベクトルのz成分
+            \return spherical_harmonic_r(l, m, θ, φ)またはspherical_harmonic_i(l, m, θ, φ)に等しい値
+        */
+        double Value(std::int32_t m, bool sine, double x, double y, double z) const;
+
+    private:
+        //!  A private member function (const).
+        /*!
+            cosθとsinθから、正規化されたP_l^mを求める
+            \param m 磁気量子数（非負）
+            \param c cosθ
+            \param pmm 正規化されたP_m^m（sin^mθを含む）
+            \return 正規化されたP_l^m
+        */
+        double Column(std::uint32_t m, double c, double pmm) const;
+
+        //!  A private static member function.
+        /*!
+            負のmの値を正のmの値から求める時の符号を返す
+            \param m 磁気量子数
+            \param sine 虚部かどうか
+            \return 符号（1または-1）
+        */
+        static double Sign(std::int32_t m, bool sine);
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            漸化式の係数（[m * (l + 1) + k]にP_k^mを求めるためのsqrt((4k^2 - 1) / (k^2 - m^2))が入る）
+        */
+        std::vector<double> a_;
+
+        //! A private member variable.
+        /*!
+            漸化式の係数（[m * (l + 1) + k]にsqrt(((k - 1)^2 - m^2) / (4(k - 1)^2 - 1))が入る）
+        */
+        std::vector<double> b_;
+
+        //! A private member variable.
+        /*!
+            方位量子数
+        */
+        std::uint32_t l_;
+
+        //! A private member variable.
+        /*!
+            P_m^m / sin^mθの値（m = 0, 1, ..., l、Condon-Shortleyの位相を含む）
+        */
+        std::vector<double> pmm_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        YlmLadder() = delete;
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        YlmLadder(YlmLadder const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        YlmLadder & operator=(YlmLadder const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _YLMLADDER_H_
@@ -0,0 +1,229 @@
+﻿/*! \file batchrejectiontest.cpp
+    \brief BatchRejectionを一つずつの棄却法と比べるテストとベンチマークの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include "testutility.h"
+#include "../getdata/getdata.h"
+#include "../myrandom/xoshiro256.h"
+#include "../sampler/balldomain.h"
+#include "../sampler/batchrejection.h"
+#include "../sampler/envelope.h"
+#include <cmath>                                                // for std::acos, std::atan2, std::fabs, std::sqrt
+#include <cstddef>                                              // for std::size_t
+#include <cstdint>                                              // for std::int32_t, std::uint32_t, std::uint64_t
+#include <string>                                               // for std::string, std::to_string
+#include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic_i, boost::math::spherical_harmonic_r
+#include <tbb/tick_count.h>                                     // for tbb::tick_count
+
+namespace test {
+    namespace {
+        //! A struct.
+        /*!
+            採択された点の統計量
+        */
+        struct Statistics final {
+            //! A public member function.
+            /*!
+                採択された点を一つ加える
+                \param x x座標
+                \param y y座標
+                \param z z座標
+                \param sign 波動関数の符号
+            */
+            void Add(double x, double y, double z, std::int32_t sign)
+            {
+                auto const r = std::sqrt(x * x + y * y + z * z);
+                auto const cos2 = z * z / (r * r);
+                n++;
+                sumr += r;
+                sumr2 += r * r;
+                sumcos2 += cos2;
+                sumcos4 += cos2 * cos2;
+                positive += sign > 0;
+            }
+
+            //! A public member variable.
+            /*!
+                採択された点の数
+            */
+            std::uint64_t n = 0;
+
+            //! A public member variable.
+            /*!
+                符号が正の点の数
+            */
+            std::uint64_t positive = 0;
+
+            //! A public member variable.
+            /*!
+                cos^2θの和
+            */
+            double sumcos2 = 0.0;
+
+            //! A public member variable.
+            /*!
+                cos^4θの和
+            */
+            double sumcos4 = 0.0;
+
+            //! A public member variable.
+            /*!
+                rの和
+            */
+            double sumr = 0.0;
+
+            //! A public member variable.
+            /*!
+                r^2の和
+            */
+            double sumr2 = 0.0;
+
+            //! A public member variable.
+            /*!
+                生成した候補の数
+            */
+            std::uint64_t trials = 0;
+        };
+
+        //! A function.
+        /*!
+            二つの標本平均の差を、その標準誤差で割った値を返す
+            \param sum1 一つ目の標本の和
+            \param sumsq1 一つ目の標本の二乗の和
+            \param n1 一つ目の標本の大きさ
+            \param sum2 二つ目の標本の和
+            \param sumsq2 二つ目の標本の二乗の和
+            \param n2 二つ目の標本の大きさ
+            \return 差の標準誤差に対する比
+        */
+        double ZScore(double sum1, double sumsq1, std::uint64_t n1, double sum2, double sumsq2, std::uint64_t n2)
+        {
+            auto const m1 = sum1 / static_cast<double>(n1), m2 = sum2 / static_cast<double>(n2);
+            auto const v1 = sumsq1 / static_cast<double>(n1) - m1 * m1;
+            auto const v2 = sumsq2 / static_cast<double>(n2) - m2 * m2;
+            return std::fabs(m1 - m2) / std::sqrt(v1 / static_cast<double>(n1) + v2 / static_cast<double>(n2));
+        }
+    }
+
+    bool BatchRejectionTest()
+    {
+        // 比べる軌道（電子密度か、主量子数、方位量子数、磁気量子数、虚部か）
+        struct Case final {
+            bool rho;
+            std::uint32_t n;
+            std::uint32_t l;
+            std::int32_t m;
+            bool sine;
+        };
+        static Case const CASES[] = {
+            { true, 2, 1, 1, false },
+            { true, 3, 2, -2, true },
+            { false, 3, 2, 2, false },
+            { false, 4, 3, -3, true },
+        };
+
+        // 一つの軌道で採択する点の数
+        static auto const NPOINT = 50000U;
+
+        // 平均の差の、標準誤差に対する比の上限
+        static auto const ZMAX = 5.0;
+
+        auto ok = true;
+        for (auto const & c : CASES) {
+            getdata::GetData const gd(WriteHydrogenFile(c.rho, c.n, c.l));
+
+            // TDXSceneと同じ球と包絡線を使う
+            auto const rmax = gd.RadialInvCdf(0.999);
+            auto const ylmmax = sampler::YlmAbsMax(c.l, c.m, c.sine);
+            auto const envelope = gd.AbsMax(gd.R_meshmin(), rmax) * (c.rho ? ylmmax * ylmmax : ylmmax) * sampler::ENVELOPE_MARGIN;
+
+            sampler::BatchRejection const batchrejection(gd, c.m, c.sine, rmax, envelope);
+            auto const name = std::string(c.rho ? "rho" : "wf") + " n = " + std::to_string(c.n) + ", l = " + std::to_string(c.l) +
+                              ", m = " + std::to_string(c.m) + (c.sine ? " (sin)" : " (cos)");
+
+            // BATCH個ずつのカーネル
+            Statistics batch;
+            myrandom::Xoshiro256 rs1(1);
+            double x[sampler::BatchRejection::BATCH], y[sampler::BatchRejection::BATCH], z[sampler::BatchRejection::BATCH];
+            std::int32_t sign[sampler::BatchRejection::BATCH];
+            auto start = tbb::tick_count::now();
+            while (batch.n < NPOINT) {
+                auto const accepted = batchrejection(rs1, x, y, z, sign);
+                batch.trials += sampler::BatchRejection::BATCH;
+                for (auto i = 0U; i < accepted; i++) {
+                    batch.Add(x[i], y[i], z[i], sign[i]);
+                }
+            }
+            auto const batchtime = (tbb::tick_count::now() - start).seconds();
+
+            // 一つずつの棄却法（acos、atan2、GetDataのスプラインとBoostの球面調和関数を使う元の方法）
+            Statistics scalar;
+            myrandom::Xoshiro256 rs2(2);
+            sampler::BallDomain const ball(rmax);
+            start = tbb::tick_count::now();
+            while (scalar.n < NPOINT) {
+                double px, py, pz;
+                auto const r = ball(rs2, px, py, pz);
+                scalar.trials++;
+                if (r < gd.R_meshmin()) {
+                    continue;
+                }
+
+                auto const p = rs2.myrand(0.0, envelope);
+                auto const theta = std::acos(pz / r);
+                auto const phi = std::atan2(py, px);
+                auto const ylm = c.sine ?
+                    boost::math::spherical_harmonic_i(c.l, c.m, theta, phi) :
+                    boost::math::spherical_harmonic_r(c.l, c.m, theta, phi);
+                auto const pp = c.rho ? gd(r) * ylm * ylm : gd(r) * ylm;
+                if (std::fabs(pp) >= p) {
+                    scalar.Add(px, py, pz, c.rho ? 1 : (pp > 0.0) - (pp < 0.0));
+                }
+            }
+            auto const scalartime = (tbb::tick_count::now() - start).seconds();
+
+            // 平均の差が統計的な揺らぎの範囲に収まっているか
+            ok = Check("BatchRejection <r>, " + name,
+                       ZScore(batch.sumr, batch.sumr2, batch.n, scalar.sumr, scalar.sumr2, scalar.n), ZMAX) && ok;
+            ok = Check("BatchRejection <cos^2>, " + name,
+                       ZScore(batch.sumcos2, batch.sumcos4, batch.n, scalar.sumcos2, scalar.sumcos4, scalar.n), ZMAX) && ok;
+
+            // 採択率（目的の分布の球内の積分に比例する）と、波動関数の符号が正の割合も同じはず
+            auto const nb = static_cast<double>(batch.n), ns = static_cast<double>(scalar.n);
+            ok = Check("BatchRejection acceptance, " + name,
+                       ZScore(nb, nb, batch.trials, ns, ns, scalar.trials), ZMAX) && ok;
+            if (!c.rho) {
+                auto const pb = static_cast<double>(batch.positive), ps = static_cast<double>(scalar.positive);
+                ok = Check("BatchRejection positive sign, " + name,
+                           ZScore(pb, pb, batch.n, ps, ps, scalar.n), ZMAX) && ok;
+            }
+
+            Benchmark(std::string("BatchRejection (") + (batchrejection.Avx2() ? "AVX2" : "portable") + ") per accepted point, " + name, batchtime, batch.n);
+            Benchmark("scalar rejection per accepted point, " + name, scalartime, scalar.n);
+        }
+
+        // 虚部でm = 0の場合は、候補がすべて符号0で採択される
+        {
+            getdata::GetData const gd(WriteHydrogenFile(false, 2, 1));
+            sampler::BatchRejection const batchrejection(gd, 0, true, gd.RadialInvCdf(0.999), 1.0);
+            myrandom::Xoshiro256 rs(3);
+            double x[sampler::BatchRejection::BATCH], y[sampler::BatchRejection::BATCH], z[sampler::BatchRejection::BATCH];
+            std::int32_t sign[sampler::BatchRejection::BATCH];
+            auto const accepted = batchrejection(rs, x, y, z, sign);
+            auto nonzero = 0;
+            for (auto i = 0U; i < accepted; i++) {
+                nonzero += sign[i] != 0;
+            }
+
+            ok = Check("BatchRejection zero wave function, rejected candidates",
+                       static_cast<double>(sampler::BatchRejection::BATCH - accepted), 0.0) && ok;
+            ok = Check("BatchRejection zero wave function, nonzero signs", static_cast<double>(nonzero), 0.0) && ok;
+        }
+
+        return ok;
+    }
+}
@@ -0,0 +1,132 @@
+﻿/*! \file getdatatest.cpp
+    \brief GetDataの動径部分をまとめて評価する関数のテストとベンチマークの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include "testutility.h"
+#include "../getdata/getdata.h"
+#include "../myrandom/xoshiro256.h"
+#include <algorithm>                // for std::max
+#include <cmath>                    // for std::fabs
+#include <iostream>                 // for std::cout
+#include <memory>                   // for std::unique_ptr
+#include <vector>                   // for std::vector
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_spline.h>
+#include <tbb/tick_count.h>         // for tbb::tick_count
+
+namespace test {
+    namespace {
+        //! A function.
+        /*!
+            gsl_interp_accelへのポインタを解放するラムダ式
+            \param acc gsl_interp_accelへのポインタ
+        */
+        auto const gsl_interp_accel_deleter = [](gsl_interp_accel * acc) {
+            gsl_interp_accel_free(acc);
+        };
+
+        //! A function.
+        /*!
+            gsl_splineへのポインタを解放するラムダ式
+            \param spline gsl_splineへのポインタ
+        */
+        auto const gsl_spline_deleter = [](gsl_spline * spline) {
+            gsl_spline_free(spline);
+        };
+    }
+
+    bool GetDataTest()
+    {
+        // 比べる点の数
+        static auto const NPOINT = 200000U;
+
+        // 一つずつ評価した値との差の許容範囲（関数の絶対値の最大値に対する比）
+        static auto const TOLERANCE = 1.0E-14;
+
+        // GSLの微分との差の許容範囲（微分の絶対値の最大値に対する比）
+        static auto const DTOLERANCE = 1.0E-12;
+
+        gsl_set_error_handler_off();
+
+        // データファイルと同じメッシュで、GSLの3次スプラインを作る
+        std::vector<double> x, y;
+        HydrogenMesh(false, 3, 2, x, y);
+        getdata::GetData const gd(WriteHydrogenFile(false, 3, 2));
+
+        std::unique_ptr<gsl_interp_accel, decltype(gsl_interp_accel_deleter)> const acc(gsl_interp_accel_alloc(), gsl_interp_accel_deleter);
+        std::unique_ptr<gsl_spline, decltype(gsl_spline_deleter)> const gslspline(
+            gsl_spline_alloc(gsl_interp_cspline, x.size()), gsl_spline_deleter);
+        gsl_spline_init(gslspline.get(), x.data(), y.data(), x.size());
+
+        // メッシュの点そのもの（両端を含む）と、メッシュの範囲内の乱数の点
+        std::vector<double> r(x);
+        myrandom::Xoshiro256 rs(6);
+        for (auto i = 0U; i < NPOINT; i++) {
+            r.push_back(rs.myrand(x.front(), x.back()));
+        }
+
+        auto const n = r.size();
+        std::vector<double> f(n), df(n), fonly(n);
+        gd(n, r.data(), f.data(), df.data());
+        gd(n, r.data(), fonly.data());
+
+        auto ymax = 0.0, dymax = 0.0, error = 0.0, fonlyerror = 0.0, derror = 0.0;
+        for (auto i = 0U; i < n; i++) {
+            auto const scalar = gd(r[i]);
+            auto const dexact = gsl_spline_eval_deriv(gslspline.get(), r[i], acc.get());
+            ymax = std::max(ymax, std::fabs(scalar));
+            dymax = std::max(dymax, std::fabs(dexact));
+            error = std::max(error, std::fabs(f[i] - scalar));
+            fonlyerror = std::max(fonlyerror, std::fabs(fonly[i] - scalar));
+            derror = std::max(derror, std::fabs(df[i] - dexact));
+        }
+
+        // メッシュの外側では、値は原点側で端の値、遠方で0、微分はどちらも0
+        double const outside[] = { 0.5 * x.front(), 1.5 * x.back() };
+        double fout[2], dfout[2];
+        gd(2, outside, fout, dfout);
+        auto const outerror = std::max(
+            std::max(std::fabs(fout[0] - y.front()), std::fabs(fout[1])),
+            std::max(std::fabs(dfout[0]), std::fabs(dfout[1])));
+
+        auto ok = true;
+        ok = Check("GetData batch values vs scalar GetData", error / ymax, TOLERANCE) && ok;
+        ok = Check("GetData batch values without derivative vs scalar GetData", fonlyerror / ymax, TOLERANCE) && ok;
+        ok = Check("GetData batch derivative vs GSL cspline (mesh ends included)", derror / dymax, DTOLERANCE) && ok;
+        ok = Check("GetData batch outside the mesh", outerror, 0.0) && ok;
+
+        // 一つずつ評価する場合と、まとめて評価する場合の速さの比較
+        static auto const NREPEAT = 10;
+        auto sum = 0.0;
+        auto start = tbb::tick_count::now();
+        for (auto k = 0; k < NREPEAT; k++) {
+            for (auto i = 0U; i < n; i++) {
+                sum += gd(r[i]);
+            }
+        }
+        Benchmark("GetData::operator()(r) (per point)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        start = tbb::tick_count::now();
+        for (auto k = 0; k < NREPEAT; k++) {
+            gd(n, r.data(), f.data());
+            sum += f[k];
+        }
+        Benchmark("GetData::operator()(n, r, f) (per point)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        start = tbb::tick_count::now();
+        for (auto k = 0; k < NREPEAT; k++) {
+            gd(n, r.data(), f.data(), df.data());
+            sum += df[k];
+        }
+        Benchmark("GetData::operator()(n, r, f, df) (per point)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        // 計算が最適化で消されないように、合計を使う
+        std::cout << "(checksum " << sum << ")" << std::endl;
+
+        return ok;
+    }
+}
@@ -0,0 +1,207 @@
+﻿/*! \file logmeshsplinetest.cpp
+    \brief LogMeshSplineをGSLの3次スプラインと比べるテストとベンチマークの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include "testutility.h"
+#include "../getdata/logmeshspline.h"
+#include "../myrandom/xoshiro256.h"
+#include <algorithm>                // for std::max
+#include <cmath>                    // for std::fabs
+#include <cstddef>                  // for std::size_t
+#include <cstdint>                  // for std::uint32_t
+#include <iostream>                 // for std::cout
+#include <memory>                   // for std::unique_ptr
+#include <string>                   // for std::string
+#include <vector>                   // for std::vector
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_spline.h>
+#include <tbb/blocked_range.h>      // for tbb::blocked_range
+#include <tbb/parallel_for.h>       // for tbb::parallel_for
+#include <tbb/tick_count.h>         // for tbb::tick_count
+
+namespace test {
+    namespace {
+        //! A function.
+        /*!
+            gsl_interp_accelへのポインタを解放するラムダ式
+            \param acc gsl_interp_accelへのポインタ
+        */
+        auto const gsl_interp_accel_deleter = [](gsl_interp_accel * acc) {
+            gsl_interp_accel_free(acc);
+        };
+
+        //! A function.
+        /*!
+            gsl_splineへのポインタを解放するラムダ式
+            \param spline gsl_splineへのポインタ
+        */
+        auto const gsl_spline_deleter = [](gsl_spline * spline) {
+            gsl_spline_free(spline);
+        };
+
+        //! A function.
+        /*!
+            一つのメッシュについて、LogMeshSplineをGSLの3次スプラインと比べる
+            \param name メッシュの名前
+            \param x メッシュ
+            \param y メッシュ上の関数の値
+            \param logmesh 対数メッシュと認識されるべきかどうか
+            \return すべてのテストに成功したらtrue
+        */
+        bool CompareWithGsl(std::string const & name, std::vector<double> const & x, std::vector<double> const & y, bool logmesh)
+        {
+            // 比べる点の数
+            static auto const NPOINT = 200000U;
+
+            // 関数の絶対値の最大値に対する、GSLとの差の許容範囲
+            static auto const TOLERANCE = 1.0E-12;
+
+            getdata::LogMeshSpline const spline(x, y);
+            std::unique_ptr<gsl_interp_accel, decltype(gsl_interp_accel_deleter)> const acc(gsl_interp_accel_alloc(), gsl_interp_accel_deleter);
+            std::unique_ptr<gsl_spline, decltype(gsl_spline_deleter)> const gslspline(
+                gsl_spline_alloc(gsl_interp_cspline, x.size()), gsl_spline_deleter);
+            gsl_spline_init(gslspline.get(), x.data(), y.data(), x.size());
+
+            // メッシュの点そのものと、メッシュの範囲内の乱数の点で比べる
+            std::vector<double> r(x);
+            myrandom::Xoshiro256 rs(4);
+            for (auto i = 0U; i < NPOINT; i++) {
+                r.push_back(rs.myrand(x.front(), x.back()));
+            }
+
+            auto ymax = 0.0;
+            std::vector<double> exact(r.size());
+            for (auto i = 0U; i < r.size(); i++) {
+                exact[i] = gsl_spline_eval(gslspline.get(), r[i], acc.get());
+                ymax = std::max(ymax, std::fabs(exact[i]));
+            }
+
+            std::vector<double> f(r.size());
+            spline.Evaluate(r.size(), r.data(), f.data(), nullptr);
+
+            auto error = 0.0, batcherror = 0.0;
+            for (auto i = 0U; i < r.size(); i++) {
+                error = std::max(error, std::fabs(spline(r[i]) - exact[i]));
+                batcherror = std::max(batcherror, std::fabs(f[i] - exact[i]));
+            }
+
+            // メッシュの外側は、原点側では端の値、遠方では0
+            double const outside[] = { 0.5 * x.front(), x.back() * 1.5 };
+            double fout[2];
+            spline.Evaluate(2, outside, fout, nullptr);
+            auto const outerror = std::max(
+                std::max(std::fabs(spline(outside[0]) - y.front()), std::fabs(fout[0] - y.front())),
+                std::max(std::fabs(spline(outside[1])), std::fabs(fout[1])));
+
+            auto ok = true;
+            ok = Check("LogMeshSpline " + name + ", log mesh detected as expected", spline.IsLogMesh() == logmesh ? 0.0 : 1.0, 0.0) && ok;
+            ok = Check("LogMeshSpline::operator() vs GSL cspline, " + name, error / ymax, TOLERANCE) && ok;
+            ok = Check("LogMeshSpline::Evaluate vs GSL cspline, " + name, batcherror / ymax, TOLERANCE) && ok;
+            ok = Check("LogMeshSpline outside the mesh, " + name, outerror, 0.0) && ok;
+
+            return ok;
+        }
+    }
+
+    bool LogMeshSplineTest()
+    {
+        // GSLのエラーハンドラでプログラムが止まらないようにする
+        gsl_set_error_handler_off();
+
+        auto ok = true;
+
+        // Schracと同じ対数メッシュ（波動関数は符号が変わる）
+        std::vector<double> x, y;
+        HydrogenMesh(false, 4, 1, x, y);
+        ok = CompareWithGsl("wf 4p (log mesh)", x, y, true) && ok;
+
+        // 対数メッシュでないメッシュでは、二分探索にフォールバックする
+        std::vector<double> xq(x.size()), yq(x.size());
+        for (auto i = 0U; i < x.size(); i++) {
+            auto const t = static_cast<double>(i + 1) / static_cast<double>(x.size());
+            xq[i] = x.back() * t * t;
+            yq[i] = HydrogenRadial(4, 1, xq[i]);
+        }
+        ok = CompareWithGsl("wf 4p (quadratic mesh)", xq, yq, false) && ok;
+
+        // 一つのオブジェクトを複数のスレッドから同時に評価しても、一つのスレッドで評価した値と一致する
+        static auto const NPOINT = 2000000U;
+        getdata::LogMeshSpline const spline(x, y);
+        std::vector<double> r(NPOINT);
+        myrandom::Xoshiro256 rs(5);
+        rs.fill(r.data(), NPOINT, 0.0, x.back() * 1.1);
+
+        std::vector<double> serial(NPOINT);
+        auto start = tbb::tick_count::now();
+        for (auto i = 0U; i < NPOINT; i++) {
+            serial[i] = spline(r[i]);
+        }
+        auto const serialtime = (tbb::tick_count::now() - start).seconds();
+
+        std::vector<double> parallel(NPOINT), parallelbatch(NPOINT);
+        start = tbb::tick_count::now();
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, NPOINT),
+            [&spline, &r, &parallel](tbb::blocked_range<std::size_t> const & range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    parallel[i] = spline(r[i]);
+                }
+            });
+        auto const paralleltime = (tbb::tick_count::now() - start).seconds();
+
+        start = tbb::tick_count::now();
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, NPOINT),
+            [&spline, &r, &parallelbatch](tbb::blocked_range<std::size_t> const & range) {
+                spline.Evaluate(range.size(), r.data() + range.begin(), parallelbatch.data() + range.begin(), nullptr);
+            });
+        auto const parallelbatchtime = (tbb::tick_count::now() - start).seconds();
+
+        auto mismatch = 0U, batchmismatch = 0U;
+        for (auto i = 0U; i < NPOINT; i++) {
+            mismatch += parallel[i] != serial[i];
+            batchmismatch += std::fabs(parallelbatch[i] - serial[i]) > 1.0E-14 * std::max(1.0, std::fabs(serial[i]));
+        }
+
+        ok = Check("LogMeshSpline::operator() under parallel_for, mismatches", static_cast<double>(mismatch), 0.0) && ok;
+        ok = Check("LogMeshSpline::Evaluate under parallel_for, mismatches", static_cast<double>(batchmismatch), 0.0) && ok;
+
+        // GSL（アクセラレータ付きで、ランダムな順に評価する）との速さの比較
+        std::unique_ptr<gsl_interp_accel, decltype(gsl_interp_accel_deleter)> const acc(gsl_interp_accel_alloc(), gsl_interp_accel_deleter);
+        std::unique_ptr<gsl_spline, decltype(gsl_spline_deleter)> const gslspline(
+            gsl_spline_alloc(gsl_interp_cspline, x.size()), gsl_spline_deleter);
+        gsl_spline_init(gslspline.get(), x.data(), y.data(), x.size());
+        rs.fill(r.data(), NPOINT, x.front(), x.back());
+
+        auto sum = 0.0;
+        start = tbb::tick_count::now();
+        for (auto i = 0U; i < NPOINT; i++) {
+            sum += gsl_spline_eval(gslspline.get(), r[i], acc.get());
+        }
+        Benchmark("gsl_spline_eval (random r)", (tbb::tick_count::now() - start).seconds(), NPOINT);
+
+        start = tbb::tick_count::now();
+        for (auto i = 0U; i < NPOINT; i++) {
+            sum += spline(r[i]);
+        }
+        Benchmark("LogMeshSpline::operator() (random r)", (tbb::tick_count::now() - start).seconds(), NPOINT);
+
+        start = tbb::tick_count::now();
+        spline.Evaluate(NPOINT, r.data(), serial.data(), nullptr);
+        sum += serial[0];
+        Benchmark("LogMeshSpline::Evaluate (random r, per point)", (tbb::tick_count::now() - start).seconds(), NPOINT);
+
+        Benchmark("LogMeshSpline::operator() under parallel_for (per point, wall clock)", paralleltime, NPOINT);
+        Benchmark("LogMeshSpline::Evaluate under parallel_for (per point, wall clock)", parallelbatchtime, NPOINT);
+        Benchmark("LogMeshSpline::operator() serial reference (per point)", serialtime, NPOINT);
+
+        // 計算が最適化で消されないように、合計を使う
+        std::cout << "(checksum " << sum << ")" << std::endl;
+
+        return ok;
+    }
+}
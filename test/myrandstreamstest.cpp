@@ -0,0 +1,193 @@
+﻿/*! \file myrandstreamstest.cpp
+    \brief MyRandStreamsをTBBの並列処理の中で使うテストとベンチマークの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include "testutility.h"
+#include "../myrandom/myrandstreams.h"
+#include <algorithm>                // for std::sort, std::unique
+#include <cmath>                    // for std::fabs, std::sqrt
+#include <cstddef>                  // for std::size_t
+#include <cstdint>                  // for std::uint64_t, std::uint_least32_t
+#include <functional>               // for std::ref
+#include <iostream>                 // for std::cout
+#include <random>                   // for std::mt19937, std::random_device, std::seed_seq, std::uniform_real_distribution
+#include <thread>                   // for std::thread
+#include <vector>                   // for std::vector
+#include <boost/range/algorithm.hpp>    // for boost::generate
+#include <tbb/blocked_range.h>      // for tbb::blocked_range
+#include <tbb/parallel_for.h>       // for tbb::parallel_for
+#include <tbb/partitioner.h>        // for tbb::simple_partitioner
+#include <tbb/tick_count.h>         // for tbb::tick_count
+
+namespace test {
+    namespace {
+        //! A function.
+        /*!
+            TBBのスレッドごとのストリームから、添字ごとに64ビットの乱数を一つずつ引く
+            \param streams スレッドごとの乱数ストリーム
+            \param values 乱数の出力先
+        */
+        void Draw(myrandom::MyRandStreams & streams, std::vector<std::uint64_t> & values)
+        {
+            // 細かく分けて、同じスレッドが何度もストリームを使い、スレッドの間で仕事が入れ替わるようにする
+            static auto const GRAINSIZE = 256U;
+
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(0, values.size(), GRAINSIZE),
+                [&streams, &values](tbb::blocked_range<std::size_t> const & range) {
+                    auto & rs = streams.local();
+                    for (auto i = range.begin(); i != range.end(); ++i) {
+                        values[i] = rs();
+                    }
+                },
+                tbb::simple_partitioner());
+        }
+
+        //! A function.
+        /*!
+            スレッドをnthread個作り、それぞれのスレッドのストリームから、出力先を等分した区間に乱数を引く
+            （コアが一つしかなくTBBのワーカースレッドが作られない環境でも、複数のストリームを使わせるため）
+            \param streams スレッドごとの乱数ストリーム
+            \param nthread スレッドの数
+            \param values 乱数の出力先
+        */
+        void DrawThreads(myrandom::MyRandStreams & streams, std::size_t nthread, std::vector<std::uint64_t> & values)
+        {
+            std::vector<std::thread> threads;
+            for (auto t = 0U; t < nthread; t++) {
+                threads.emplace_back([&streams, &values, nthread, t] {
+                    auto & rs = streams.local();
+                    auto const end = values.size() * (t + 1) / nthread;
+                    for (auto i = values.size() * t / nthread; i < end; ++i) {
+                        values[i] = rs();
+                    }
+                });
+            }
+
+            for (auto & th : threads) {
+                th.join();
+            }
+        }
+
+        //! A function.
+        /*!
+            64ビットの乱数の中に、同じ値が現れた回数を返す
+            \param values 乱数
+            \return 重複の数
+        */
+        std::size_t Duplicates(std::vector<std::uint64_t> values)
+        {
+            std::sort(values.begin(), values.end());
+            return static_cast<std::size_t>(values.end() - std::unique(values.begin(), values.end()));
+        }
+    }
+
+    bool MyRandStreamsTest()
+    {
+        // 引く乱数の数
+        static auto const NDRAW = 1U << 20;
+
+        // 乱数を引くスレッドの数
+        static auto const NTHREAD = 4U;
+
+        // 一様分布の検定の区間の数
+        static auto const NBIN = 64U;
+
+        // 標準誤差に対する比の上限
+        static auto const ZMAX = 5.0;
+
+        myrandom::MyRandStreams streams;
+
+        // スレッドごとのストリームが互いに重ならなければ、64ビットの乱数はほぼ確実にすべて異なる
+        std::vector<std::uint64_t> values(NDRAW);
+        Draw(streams, values);
+
+        auto ok = true;
+        ok = Check("MyRandStreams under parallel_for, duplicated 64-bit values", static_cast<double>(Duplicates(values)), 0.0) && ok;
+
+        std::vector<std::uint64_t> threaded(NDRAW);
+        DrawThreads(streams, NTHREAD, threaded);
+        threaded.insert(threaded.end(), values.begin(), values.end());
+        ok = Check("MyRandStreams on 4 threads, duplicated 64-bit values", static_cast<double>(Duplicates(threaded)), 0.0) && ok;
+
+        // jump()したエンジンは、元のエンジンと同じ種からでも異なる列を生成する
+        myrandom::Xoshiro256 original(1), jumped(1);
+        jumped.jump();
+        auto same = 0U;
+        for (auto i = 0; i < 1000; i++) {
+            if (original() == jumped()) {
+                ++same;
+            }
+        }
+        ok = Check("Xoshiro256::jump(), values equal to the unjumped engine", static_cast<double>(same), 0.0) && ok;
+
+        // [0, 1)の一様乱数としての平均とχ^2検定
+        std::vector<double> histogram(NBIN, 0.0);
+        auto sum = 0.0;
+        for (auto const v : values) {
+            auto const u = static_cast<double>(v >> 11) * (1.0 / 9007199254740992.0);
+            sum += u;
+            histogram[static_cast<std::size_t>(u * static_cast<double>(NBIN))] += 1.0;
+        }
+
+        auto const mean = sum / static_cast<double>(NDRAW);
+        ok = Check("MyRandStreams under parallel_for, mean of uniform [0, 1) (z-score)",
+                   std::fabs(mean - 0.5) / std::sqrt(1.0 / (12.0 * static_cast<double>(NDRAW))), ZMAX) && ok;
+
+        auto const expected = static_cast<double>(NDRAW) / static_cast<double>(NBIN);
+        auto chi2 = 0.0;
+        for (auto const h : histogram) {
+            chi2 += (h - expected) * (h - expected) / expected;
+        }
+
+        auto const dof = static_cast<double>(NBIN - 1);
+        ok = Check("MyRandStreams under parallel_for, chi-square of 64 bins (z-score)",
+                   std::fabs(chi2 - dof) / std::sqrt(2.0 * dof), ZMAX) && ok;
+
+        // 作り直したストリームは、前のストリームと重ならない
+        std::vector<std::uint64_t> reseeded(NDRAW);
+        streams.reseed();
+        Draw(streams, reseeded);
+        reseeded.insert(reseeded.end(), values.begin(), values.end());
+        ok = Check("MyRandStreams after reseed(), values shared with the previous streams", static_cast<double>(Duplicates(reseeded)), 0.0) && ok;
+
+        // 頂点ごとに乱数エンジンを二つ作っていた元の方法と、スレッドごとのストリームを使う方法の速さの比較
+        static auto const NVERTEX = 20000U;
+        auto check = 0.0;
+        auto start = tbb::tick_count::now();
+        for (auto i = 0U; i < NVERTEX; i++) {
+            for (auto k = 0; k < 2; k++) {
+                std::random_device rnd;
+                std::vector<std::uint_least32_t> v(64);
+                boost::generate(v, std::ref(rnd));
+                std::seed_seq seq(v.begin(), v.end());
+                std::mt19937 engine(seq);
+                std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+                check += distribution(engine) + distribution(engine);
+            }
+        }
+        Benchmark("two seeded std::mt19937 per vertex (4 draws)", (tbb::tick_count::now() - start).seconds(), NVERTEX);
+
+        start = tbb::tick_count::now();
+        for (auto i = 0U; i < NVERTEX; i++) {
+            auto & rs = streams.local();
+            for (auto k = 0; k < 4; k++) {
+                check += rs.myrand(-1.0, 1.0);
+            }
+        }
+        Benchmark("MyRandStreams::local() per vertex (4 draws)", (tbb::tick_count::now() - start).seconds(), NVERTEX);
+
+        start = tbb::tick_count::now();
+        Draw(streams, values);
+        Benchmark("MyRandStreams under parallel_for (per 64-bit value, wall clock)", (tbb::tick_count::now() - start).seconds(), NDRAW);
+
+        // 計算が最適化で消されないように、合計を使う
+        std::cout << "(checksum " << check << ")" << std::endl;
+
+        return ok;
+    }
+}
@@ -0,0 +1,31 @@
+﻿/*! \file schracvisualizetest.cpp
+    \brief SchracVisualizeのサンプラーと補間のテストとベンチマークを実行するメインファイル
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include <cstdlib>      // for EXIT_FAILURE, EXIT_SUCCESS
+#include <exception>    // for std::exception
+#include <iostream>     // for std::cerr, std::cout
+
+int main()
+{
+    try {
+        // 失敗したテストがあっても、残りのテストはすべて実行する
+        auto ok = true;
+        ok = test::YlmTest() && ok;
+        ok = test::BatchRejectionTest() && ok;
+        ok = test::LogMeshSplineTest() && ok;
+        ok = test::MyRandStreamsTest() && ok;
+        ok = test::GetDataTest() && ok;
+
+        std::cout << (ok ? "All tests passed." : "Some tests FAILED.") << std::endl;
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (std::exception const & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,50 @@
+﻿/*! \file tests.h
+    \brief 各テストとベンチマークを実行する関数の宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TESTS_H_
+#define _TESTS_H_
+
+#pragma once
+
+namespace test {
+    //! A function.
+    /*!
+        BatchRejectionで採択された点の分布を、一つずつの棄却法と比べるテストとベンチマーク
+        \return すべてのテストに成功したらtrue
+    */
+    bool BatchRejectionTest();
+
+    //! A function.
+    /*!
+        GetDataの動径部分をまとめて評価する関数を、一つずつ評価した値とGSLの3次スプラインの微分と比べるテストとベンチマーク
+        \return すべてのテストに成功したらtrue
+    */
+    bool GetDataTest();
+
+    //! A function.
+    /*!
+        LogMeshSplineをGSLの3次スプラインと比べ、複数のスレッドから同時に評価できることを確かめるテストとベンチマーク
+        \return すべてのテストに成功したらtrue
+    */
+    bool LogMeshSplineTest();
+
+    //! A function.
+    /*!
+        MyRandStreamsのスレッドごとのストリームが、TBBの並列処理の中で重ならずに一様乱数を生成することを確かめるテストとベンチマーク
+        \return すべてのテストに成功したらtrue
+    */
+    bool MyRandStreamsTest();
+
+    //! A function.
+    /*!
+        CartesianYlmとYlmLadderを、Boostの球面調和関数と比べるテストとベンチマーク
+        \return すべてのテストに成功したらtrue
+    */
+    bool YlmTest();
+}
+
+#endif  // _TESTS_H_
@@ -0,0 +1,81 @@
+﻿/*! \file testutility.cpp
+    \brief テストとベンチマークで共通に使う関数の実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "testutility.h"
+#include <cmath>                                            // for std::exp, std::log, std::pow, std::sqrt
+#include <fstream>                                          // for std::ofstream
+#include <iomanip>                                          // for std::setprecision
+#include <iostream>                                         // for std::cout
+#include <stdexcept>                                        // for std::runtime_error
+#include <boost/math/special_functions/factorials.hpp>      // for boost::math::factorial
+#include <boost/math/special_functions/laguerre.hpp>        // for boost::math::laguerre
+
+namespace test {
+    void Benchmark(std::string const & name, double seconds, std::size_t n)
+    {
+        std::cout << "[ BENCH] " << name << ": "
+                  << std::setprecision(4) << seconds / static_cast<double>(n) * 1.0E+9 << " ns" << std::endl;
+    }
+
+    bool Check(std::string const & name, double error, double tolerance)
+    {
+        // NaNも失敗として扱う
+        auto const ok = error <= tolerance;
+        std::cout << (ok ? "[  OK  ] " : "[FAILED] ") << name << ": error = "
+                  << std::setprecision(3) << error << " (tolerance = " << tolerance << ")" << std::endl;
+
+        return ok;
+    }
+
+    double HydrogenRadial(std::uint32_t n, std::uint32_t l, double r)
+    {
+        using boost::math::factorial;
+
+        auto const rho = 2.0 * r / static_cast<double>(n);
+        auto const norm = std::sqrt(
+            std::pow(2.0 / static_cast<double>(n), 3) * factorial<double>(n - l - 1) /
+            (2.0 * static_cast<double>(n) * factorial<double>(n + l)));
+
+        return norm * std::exp(-0.5 * rho) * std::pow(rho, static_cast<double>(l)) * boost::math::laguerre(n - l - 1, 2 * l + 1, rho);
+    }
+
+    void HydrogenMesh(bool rho, std::uint32_t n, std::uint32_t l, std::vector<double> & r, std::vector<double> & f)
+    {
+        // Schracと同じく、r_i = r_0 exp(i dx)の対数メッシュにする
+        static auto const NMESH = 4000;
+        static auto const RMIN = 1.0E-5;
+        auto const rmax = 80.0 * static_cast<double>(n);
+
+        auto const dx = std::log(rmax / RMIN) / static_cast<double>(NMESH - 1);
+        r.resize(NMESH);
+        f.resize(NMESH);
+        for (auto i = 0; i < NMESH; i++) {
+            r[i] = RMIN * std::exp(dx * static_cast<double>(i));
+            auto const radial = HydrogenRadial(n, l, r[i]);
+            f[i] = rho ? radial * radial : radial;
+        }
+    }
+
+    std::string WriteHydrogenFile(bool rho, std::uint32_t n, std::uint32_t l)
+    {
+        auto const filename = std::string(rho ? "rho" : "wf") + "_H_" + std::to_string(n) + "spdfg"[l] + ".csv";
+        std::ofstream ofs(filename);
+        if (!ofs) {
+            throw std::runtime_error("データファイルが作れません！");
+        }
+
+        std::vector<double> r, f;
+        HydrogenMesh(rho, n, l, r, f);
+
+        ofs << std::setprecision(17);
+        for (auto i = 0U; i < r.size(); i++) {
+            ofs << r[i] << ',' << f[i] << '\n';
+        }
+
+        return filename;
+    }
+}
@@ -0,0 +1,70 @@
+﻿/*! \file testutility.h
+    \brief テストとベンチマークで共通に使う関数の宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _TESTUTILITY_H_
+#define _TESTUTILITY_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+
+namespace test {
+    //! A function.
+    /*!
+        ベンチマークの結果を、一回あたりの時間で表示する
+        \param name ベンチマークの名前
+        \param seconds かかった時間（秒）
+        \param n 繰り返した回数
+    */
+    void Benchmark(std::string const & name, double seconds, std::size_t n);
+
+    //! A function.
+    /*!
+        誤差が許容範囲に収まっているかどうかを表示する
+        \param name テストの名前
+        \param error 誤差
+        \param tolerance 許容される誤差
+        \return 誤差が許容範囲に収まっていればtrue
+    */
+    bool Check(std::string const & name, double error, double tolerance);
+
+    //! A function.
+    /*!
+        水素原子の動径波動関数R_nl(r)を求める
+        \param n 主量子数
+        \param l 方位量子数
+        \param r rの値
+        \return R_nl(r)の値
+    */
+    double HydrogenRadial(std::uint32_t n, std::uint32_t l, double r);
+
+    //! A function.
+    /*!
+        水素原子の電子密度または波動関数を、Schracと同じ対数メッシュ上で求める
+        \param rho 電子密度を求めるならtrue、波動関数ならfalse
+        \param n 主量子数
+        \param l 方位量子数
+        \param r メッシュの出力先
+        \param f メッシュ上の関数の値の出力先
+    */
+    void HydrogenMesh(bool rho, std::uint32_t n, std::uint32_t l, std::vector<double> & r, std::vector<double> & f);
+
+    //! A function.
+    /*!
+        水素原子の電子密度または波動関数を、Schracと同じ対数メッシュ上でデータファイルに書き出す
+        \param rho 電子密度を書き出すならtrue、波動関数ならfalse
+        \param n 主量子数
+        \param l 方位量子数（0～4）
+        \return データファイル名（GetDataが解釈できる名前、カレントディレクトリに作る）
+    */
+    std::string WriteHydrogenFile(bool rho, std::uint32_t n, std::uint32_t l);
+}
+
+#endif  // _TESTUTILITY_H_
@@ -0,0 +1,150 @@
+﻿/*! \file ylmtest.cpp
+    \brief CartesianYlmとYlmLadderを、Boostの球面調和関数と比べるテストとベンチマークの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "tests.h"
+#include "testutility.h"
+#include "../sampler/cartesianylm.h"
+#include "../sampler/ylmladder.h"
+#include <algorithm>                                            // for std::max
+#include <cmath>                                                // for std::cos, std::fabs, std::sin
+#include <cstdint>                                              // for std::int32_t, std::uint32_t
+#include <iostream>                                             // for std::cout
+#include <memory>                                               // for std::unique_ptr
+#include <vector>                                               // for std::vector
+#include <boost/math/constants/constants.hpp>                   // for boost::math::constants::pi
+#include <boost/math/special_functions/spherical_harmonic.hpp>  // for boost::math::spherical_harmonic_i, boost::math::spherical_harmonic_r
+#include <tbb/tick_count.h>                                     // for tbb::tick_count
+
+namespace test {
+    bool YlmTest()
+    {
+        using boost::math::constants::pi;
+
+        // 比べる方位量子数の上限
+        static auto const LMAX = 8U;
+
+        // 方向の格子（θは両極を含める）
+        static auto const NTHETA = 32;
+        static auto const NPHI = 64;
+
+        // Boostとの差の許容範囲
+        static auto const TOLERANCE = 1.0E-14;
+
+        std::vector<double> theta, phi, x, y, z;
+        for (auto i = 0; i <= NTHETA; i++) {
+            for (auto j = 0; j < NPHI; j++) {
+                theta.push_back(pi<double>() * static_cast<double>(i) / static_cast<double>(NTHETA));
+                phi.push_back(2.0 * pi<double>() * (static_cast<double>(j) + 0.5) / static_cast<double>(NPHI));
+                x.push_back(std::sin(theta.back()) * std::cos(phi.back()));
+                y.push_back(std::sin(theta.back()) * std::sin(phi.back()));
+                z.push_back(std::cos(theta.back()));
+            }
+        }
+
+        auto const n = theta.size();
+        auto cartesianerror = 0.0, valueerror = 0.0, ladderror = 0.0, evaluateerror = 0.0;
+        for (auto l = 0U; l <= LMAX; l++) {
+            sampler::YlmLadder const ladder(l);
+
+            // すべてのmを一度に求めた値
+            std::vector<double> re((l + 1) * n), im((l + 1) * n);
+            for (auto k = 0U; k < n; k++) {
+                ladder(x[k], y[k], z[k], re.data() + k * (l + 1), im.data() + k * (l + 1));
+            }
+
+            // 方向をまとめて求めた値
+            std::vector<double> batchre((l + 1) * n), batchim((l + 1) * n);
+            ladder.Evaluate(n, x.data(), y.data(), z.data(), batchre.data(), batchim.data());
+
+            for (auto m = -static_cast<std::int32_t>(l); m <= static_cast<std::int32_t>(l); m++) {
+                for (auto const sine : { false, true }) {
+                    std::unique_ptr<sampler::CartesianYlm> pcartesianylm;
+                    if (l <= sampler::CartesianYlm::LMAX) {
+                        pcartesianylm.reset(new sampler::CartesianYlm(l, m, sine));
+                    }
+
+                    for (auto k = 0U; k < n; k++) {
+                        auto const exact = sine ?
+                            boost::math::spherical_harmonic_i(l, m, theta[k], phi[k]) :
+                            boost::math::spherical_harmonic_r(l, m, theta[k], phi[k]);
+
+                        if (pcartesianylm) {
+                            cartesianerror = std::max(cartesianerror, std::fabs((*pcartesianylm)(x[k], y[k], z[k]) - exact));
+                        }
+
+                        valueerror = std::max(valueerror, std::fabs(ladder.Value(m, sine, x[k], y[k], z[k]) - exact));
+
+                        auto const offset = k * (l + 1);
+                        ladderror = std::max(ladderror, std::fabs(sampler::YlmLadder::Component(re.data() + offset, im.data() + offset, m, sine) - exact));
+                        evaluateerror = std::max(evaluateerror, std::fabs(sampler::YlmLadder::Component(batchre.data() + offset, batchim.data() + offset, m, sine) - exact));
+                    }
+                }
+            }
+        }
+
+        auto ok = true;
+        ok = Check("CartesianYlm vs Boost (l <= 4)", cartesianerror, TOLERANCE) && ok;
+        ok = Check("YlmLadder::Value vs Boost (l <= 8)", valueerror, TOLERANCE) && ok;
+        ok = Check("YlmLadder::operator() vs Boost (l <= 8)", ladderror, TOLERANCE) && ok;
+        ok = Check("YlmLadder::Evaluate vs Boost (l <= 8)", evaluateerror, TOLERANCE) && ok;
+
+        // 一つの(l, m)の値を、方向ごとに求める時間を比べる
+        static auto const NREPEAT = 200;
+        static auto const L = 3U;
+        static auto const M = 2;
+        sampler::CartesianYlm const cartesianylm(L, M, false);
+        sampler::YlmLadder const ladder(L);
+        std::vector<double> re(L + 1), im(L + 1);
+        auto sum = 0.0;
+
+        auto start = tbb::tick_count::now();
+        for (auto i = 0; i < NREPEAT; i++) {
+            for (auto k = 0U; k < n; k++) {
+                sum += boost::math::spherical_harmonic_r(L, M, theta[k], phi[k]);
+            }
+        }
+        Benchmark("boost::math::spherical_harmonic_r (l = 3, m = 2)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        start = tbb::tick_count::now();
+        for (auto i = 0; i < NREPEAT; i++) {
+            for (auto k = 0U; k < n; k++) {
+                sum += cartesianylm(x[k], y[k], z[k]);
+            }
+        }
+        Benchmark("CartesianYlm (l = 3, m = 2)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        start = tbb::tick_count::now();
+        for (auto i = 0; i < NREPEAT; i++) {
+            for (auto k = 0U; k < n; k++) {
+                sum += ladder.Value(M, false, x[k], y[k], z[k]);
+            }
+        }
+        Benchmark("YlmLadder::Value (l = 3, m = 2)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        start = tbb::tick_count::now();
+        for (auto i = 0; i < NREPEAT; i++) {
+            for (auto k = 0U; k < n; k++) {
+                ladder(x[k], y[k], z[k], re.data(), im.data());
+                sum += re[M];
+            }
+        }
+        Benchmark("YlmLadder::operator() (l = 3, all m)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        std::vector<double> batchre((L + 1) * n), batchim((L + 1) * n);
+        start = tbb::tick_count::now();
+        for (auto i = 0; i < NREPEAT; i++) {
+            ladder.Evaluate(n, x.data(), y.data(), z.data(), batchre.data(), batchim.data());
+            sum += batchre[M];
+        }
+        Benchmark("YlmLadder::Evaluate (l = 3, all m, per direction)", (tbb::tick_count::now() - start).seconds(), NREPEAT * n);
+
+        // 計算が最適化で消されないように、合計を使う
+        std::cout << "(checksum " << sum << ")" << std::endl;
+
+        return ok;
+    }
+}
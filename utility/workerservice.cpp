@@ -0,0 +1,81 @@
+﻿/*! \file workerservice.cpp
+    \brief 常駐するワーカースレッドにジョブを渡すクラスの実装
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "DXUT.h"
+#include "workerservice.h"
+
+namespace utility {
+    // #region コンストラクタ・デストラクタ
+
+    WorkerService::WorkerService() :
+        coalesced_(0),
+        completed_(0),
+        submitted_(0)
+    {
+        // タスクアリーナは、最初のジョブより先にここで用意しておく
+        arena_.initialize();
+        worker_ = std::thread([this] { Run(); });
+    }
+
+    WorkerService::~WorkerService()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.reset();
+            stop_ = true;
+        }
+
+        cv_.notify_one();
+        worker_.join();
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region メンバ関数
+
+    std::future<void> WorkerService::Submit(std::function<void()> const & job)
+    {
+        std::unique_ptr<std::packaged_task<void()>> task(new std::packaged_task<void()>(job));
+        auto result = task->get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_) {
+                coalesced_++;
+            }
+
+            pending_ = std::move(task);
+        }
+
+        submitted_++;
+        cv_.notify_one();
+        return result;
+    }
+
+    void WorkerService::Run()
+    {
+        while (true) {
+            std::unique_ptr<std::packaged_task<void()>> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || pending_; });
+                if (stop_) {
+                    return;
+                }
+
+                task = std::move(pending_);
+            }
+
+            // ジョブの中のtbb::parallel_forは、常駐するアリーナのワーカーで実行される
+            arena_.execute([&task] { (*task)(); });
+            completed_++;
+        }
+    }
+
+    // #endregion メンバ関数
+}
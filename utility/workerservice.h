@@ -0,0 +1,177 @@
+﻿/*! \file workerservice.h
+    \brief 常駐するワーカースレッドにジョブを渡すクラスの宣言
+
+    Copyright © 2015 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _WORKERSERVICE_H_
+#define _WORKERSERVICE_H_
+
+#pragma once
+
+#include <atomic>               // for std::atomic
+#include <condition_variable>   // for std::condition_variable
+#include <cstdint>              // for std::uint64_t
+#include <functional>           // for std::function
+#include <future>               // for std::future, std::packaged_task
+#include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::mutex
+#include <thread>               // for std::thread
+#include <tbb/task_arena.h>     // for tbb::task_arena
+
+namespace utility {
+    //! A class.
+    /*!
+        一本のワーカースレッドとTBBのタスクアリーナを常駐させ、渡されたジョブを順に実行するクラス
+        まだ始まっていないジョブは、新しいジョブが渡されると捨てられる（最新の要求だけが実行される）
+    */
+    class WorkerService final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            ワーカースレッドを起動する
+        */
+        WorkerService();
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            まだ始まっていないジョブを捨て、実行中のジョブの終了を待ってからワーカースレッドを終了する
+        */
+        ~WorkerService();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region メンバ関数
+
+        //!  A public member function (const).
+        /*!
+            始まる前に新しいジョブに置き換えられたジョブの数を返す
+            \return 置き換えられたジョブの数
+        */
+        std::uint64_t Coalesced() const
+        {
+            return coalesced_.load();
+        }
+
+        //!  A public member function (const).
+        /*!
+            実行し終えたジョブの数を返す
+            \return 実行し終えたジョブの数
+        */
+        std::uint64_t Completed() const
+        {
+            return completed_.load();
+        }
+
+        //!  A public member function (const).
+        /*!
+            渡されたジョブの数を返す
+            \return 渡されたジョブの数
+        */
+        std::uint64_t Submitted() const
+        {
+            return submitted_.load();
+        }
+
+        //!  A public member function.
+        /*!
+            ジョブを渡す（呼び出し側はブロックしない）
+            まだ始まっていない前のジョブは捨てられ、そのstd::futureはstd::future_errorを投げるようになる
+            \param job 実行するジョブ
+            \return ジョブの完了を表すstd::future
+        */
+        std::future<void> Submit(std::function<void()> const & job);
+
+    private:
+        //!  A private member function.
+        /*!
+            ワーカースレッドの本体
+        */
+        void Run();
+
+        // #endregion メンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            ジョブの中のTBBの並列処理が使うタスクアリーナ
+        */
+        tbb::task_arena arena_;
+
+        //! A private member variable.
+        /*!
+            始まる前に新しいジョブに置き換えられたジョブの数
+        */
+        std::atomic<std::uint64_t> coalesced_;
+
+        //! A private member variable.
+        /*!
+            実行し終えたジョブの数
+        */
+        std::atomic<std::uint64_t> completed_;
+
+        //! A private member variable.
+        /*!
+            ジョブが渡されたか、終了が要求されたことを知らせる条件変数
+        */
+        std::condition_variable cv_;
+
+        //! A private member variable.
+        /*!
+            pending_とstop_を保護するミューテックス
+        */
+        std::mutex mutex_;
+
+        //! A private member variable.
+        /*!
+            まだ始まっていないジョブ
+        */
+        std::unique_ptr<std::packaged_task<void()>> pending_;
+
+        //! A private member variable.
+        /*!
+            ワーカースレッドの終了が要求されたかどうか
+        */
+        bool stop_ = false;
+
+        //! A private member variable.
+        /*!
+            渡されたジョブの数
+        */
+        std::atomic<std::uint64_t> submitted_;
+
+        //! A private member variable.
+        /*!
+            ワーカースレッド
+        */
+        std::thread worker_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+        //! A private copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+        */
+        WorkerService(WorkerService const &) = delete;
+
+        //! A private member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        WorkerService & operator=(WorkerService const &) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _WORKERSERVICE_H_